@@ -0,0 +1,233 @@
+// Benchmarks of the font loading, glyph decoding, codePoint translation and font
+// comparison, on synthetic fonts. See the README for the build command.
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <streambuf>
+#include <string>
+#include <tuple>
+#include <unistd.h>
+#include <vector>
+
+#include "FontDiffEngine.hpp"
+#include "FontGenerator.hpp"
+#include "FontWriter.hpp"
+#include "IBMFFontDiff.hpp"
+#include "MappedFile.hpp"
+#include "TextReporter.hpp"
+#include "ThreadPool.hpp"
+
+// Discards the reports, only their formatting is measured
+class NullBuffer : public std::streambuf {
+protected:
+  auto overflow(int ch) -> int override { return ch; }
+  auto xsputn(const char *, std::streamsize count) -> std::streamsize override { return count; }
+};
+
+// Each odd row of the glyph bitmap becomes a copy of the row above it, such that the RLE
+// packets have repeat counts
+static auto repeatRows(FontModel::Glyph &glyph) -> void {
+  for (int row = 1; row < glyph.height; row += 2) {
+    std::copy_n(glyph.pixels.begin() + ((row - 1) * glyph.width), glyph.width,
+                glyph.pixels.begin() + (row * glyph.width));
+  }
+}
+
+// The fonts are generated once, on first use. The font is empty if it cannot be
+// generated, the benchmark being then skipped.
+static auto getFont(const FontGeneratorOptions &options, bool repeatedRows = false)
+    -> const std::vector<uint8_t> & {
+  static std::map<std::tuple<int, int, std::vector<int>, int, uint32_t, bool>,
+                  std::vector<uint8_t>>
+      fonts;
+
+  auto  key  = std::make_tuple(options.faceCount, options.glyphCount, options.dynFs,
+                               options.changedGlyphs, options.variant, repeatedRows);
+  auto &font = fonts[key];
+  if (font.empty()) {
+    FontModel model;
+    bool      built = FontGenerator(options).build(model);
+
+    if (built && repeatedRows) {
+      for (auto &face : model.faces) {
+        for (auto &glyph : face.glyphs) repeatRows(glyph);
+      }
+    }
+    if (!built || !FontWriter(model).write(font)) font.clear();
+  }
+  return font;
+}
+
+static auto fontOptions(int faceCount, int glyphCount, int dynF = -1, int changedGlyphs = 0,
+                        uint32_t variant = 0) -> FontGeneratorOptions {
+  FontGeneratorOptions options;
+  options.faceCount     = faceCount;
+  options.glyphCount    = glyphCount;
+  options.changedGlyphs = changedGlyphs;
+  options.variant       = variant;
+  if (dynF >= 0) options.dynFs = {dynF};
+  return options;
+}
+
+static auto loadFont(const std::vector<uint8_t> &font) -> IBMFFontDiffPtr {
+  return IBMFFontDiffPtr(new IBMFFontDiff(const_cast<uint8_t *>(font.data()), font.size()));
+}
+
+// Font copied in memory, validated and loaded, with its content hashes.
+// Args: faceCount, glyphCount
+static void BM_Load(benchmark::State &state) {
+  const std::vector<uint8_t> &font = getFont(fontOptions(state.range(0), state.range(1)));
+  if (font.empty()) {
+    state.SkipWithError("Unable to generate the font");
+    return;
+  }
+
+  for (auto _ : state) {
+    IBMFFontDiff fontDiff(const_cast<uint8_t *>(font.data()), font.size());
+    benchmark::DoNotOptimize(fontDiff.isInitialized());
+  }
+  state.SetBytesProcessed(state.iterations() * font.size());
+}
+BENCHMARK(BM_Load)
+    ->Args({1, 1000})
+    ->Args({4, 8000})
+    ->Args({8, 32000})
+    ->Unit(benchmark::kMillisecond);
+
+// Font mapped from a file, without the content hashes. Args: faceCount, glyphCount
+static void BM_LoadMapped(benchmark::State &state) {
+  const std::vector<uint8_t> &font = getFont(fontOptions(state.range(0), state.range(1)));
+  if (font.empty()) {
+    state.SkipWithError("Unable to generate the font");
+    return;
+  }
+
+  char  filename[] = "/tmp/ibmf_bench_XXXXXX";
+  int   fd         = mkstemp(filename);
+  FILE *file       = fdopen(fd, "wb");
+  fwrite(font.data(), 1, font.size(), file);
+  fclose(file);
+
+  MappedFilePtr mappedFile = MappedFilePtr(new MappedFile(filename));
+  for (auto _ : state) {
+    IBMFFontDiff fontDiff(mappedFile, false);
+    benchmark::DoNotOptimize(fontDiff.isInitialized());
+  }
+  state.SetBytesProcessed(state.iterations() * font.size());
+  unlink(filename);
+}
+BENCHMARK(BM_LoadMapped)->Args({1, 1000})->Args({8, 32000})->Unit(benchmark::kMillisecond);
+
+// Decompression of every glyph of a face, all RLE packets using the same dynF. With
+// repeated rows, half of the bitmap rows are decoded from repeat counts.
+// Args: dynF, repeated rows (0 or 1)
+static void BM_RetrieveBitmap(benchmark::State &state) {
+  const std::vector<uint8_t> &fontData =
+      getFont(fontOptions(1, 4000, state.range(0)), state.range(1) != 0);
+  if (fontData.empty()) {
+    state.SkipWithError("Unable to generate the font");
+    return;
+  }
+
+  IBMFFontDiffPtr       font = loadFont(fontData);
+  IBMFFontDiff::FacePtr face = font->getFace(0);
+  Bitmap                bitmap;
+  int                   glyphCount = face->header->glyphCount;
+
+  for (auto _ : state) {
+    for (GlyphCode glyphCode = 0; glyphCode < glyphCount; glyphCode++) {
+      face->retrieveBitmap(glyphCode, bitmap);
+      benchmark::DoNotOptimize(bitmap.pixels.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * glyphCount);
+}
+static void retrieveBitmapArgs(benchmark::internal::Benchmark *bench) {
+  for (int repeatedRows = 0; repeatedRows <= 1; repeatedRows++) {
+    for (int dynF = 0; dynF <= 14; dynF++) bench->Args({dynF, repeatedRows});
+  }
+}
+BENCHMARK(BM_RetrieveBitmap)->Apply(retrieveBitmapArgs);
+
+// CodePoint to glyphCode, for every codePoint of a font. Arg: glyphCount
+static void BM_Translate(benchmark::State &state) {
+  const std::vector<uint8_t> &fontData = getFont(fontOptions(1, state.range(0)));
+  if (fontData.empty()) {
+    state.SkipWithError("Unable to generate the font");
+    return;
+  }
+
+  IBMFFontDiffPtr       font = loadFont(fontData);
+  std::vector<char32_t> codePoints;
+
+  for (GlyphCode glyphCode = 0; glyphCode < state.range(0); glyphCode++) {
+    codePoints.push_back(font->getUTF32(glyphCode));
+  }
+
+  for (auto _ : state) {
+    for (char32_t codePoint : codePoints) benchmark::DoNotOptimize(font->translate(codePoint));
+  }
+  state.SetItemsProcessed(state.iterations() * codePoints.size());
+}
+BENCHMARK(BM_Translate)->Arg(1000)->Arg(32000);
+
+// GlyphCode to codePoint, for every glyph of a font. Arg: glyphCount
+static void BM_GetUTF32(benchmark::State &state) {
+  const std::vector<uint8_t> &fontData = getFont(fontOptions(1, state.range(0)));
+  if (fontData.empty()) {
+    state.SkipWithError("Unable to generate the font");
+    return;
+  }
+
+  IBMFFontDiffPtr font       = loadFont(fontData);
+  int             glyphCount = state.range(0);
+
+  for (auto _ : state) {
+    for (GlyphCode glyphCode = 0; glyphCode < glyphCount; glyphCode++) {
+      benchmark::DoNotOptimize(font->getUTF32(glyphCode));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * glyphCount);
+}
+BENCHMARK(BM_GetUTF32)->Arg(1000)->Arg(32000);
+
+// Comparison of a font with a variant, reported in the text format. The fonts are
+// loaded again before each run, their bitmaps being cached once decoded.
+// Args: faceCount, glyphCount, percentage of changed glyphs, ligKernPairs option
+static void BM_CompareFonts(benchmark::State &state) {
+  const std::vector<uint8_t> &font1 = getFont(fontOptions(state.range(0), state.range(1)));
+  const std::vector<uint8_t> &font2 =
+      getFont(fontOptions(state.range(0), state.range(1), -1, state.range(2), 1));
+  if (font1.empty() || font2.empty()) {
+    state.SkipWithError("Unable to generate the fonts");
+    return;
+  }
+
+  static ThreadPool pool;
+  NullBuffer        buffer;
+  std::ostream      stream(&buffer);
+  DiffOptions       options;
+  options.ligKernPairs = state.range(3) != 0;
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    IBMFFontDiffPtr fontDiff1 = loadFont(font1);
+    IBMFFontDiffPtr fontDiff2 = loadFont(font2);
+    TextReporter    reporter(stream);
+    state.ResumeTiming();
+
+    FontDiffEngine engine(fontDiff1, fontDiff2, pool, options);
+    benchmark::DoNotOptimize(engine.run(reporter));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(1));
+}
+BENCHMARK(BM_CompareFonts)
+    ->Args({4, 8000, 1, 0})
+    ->Args({4, 8000, 20, 0})
+    ->Args({4, 8000, 20, 1})
+    ->Args({8, 32000, 5, 0})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
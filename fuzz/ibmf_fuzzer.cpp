@@ -0,0 +1,66 @@
+// libFuzzer target of the IBMF font parser.
+//
+// The input is loaded as a font. When accepted, every face is retrieved and its
+// glyphs decoded and shown, as done by the comparison of two fonts. See the README
+// for the build command.
+
+#include <cinttypes>
+#include <cstddef>
+#include <sstream>
+#include <vector>
+
+#include "IBMFFontDiff.hpp"
+#include "ReportWriter.hpp"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  // The font content is copied by the constructor
+  IBMFFontDiff font(const_cast<uint8_t *>(data), size);
+
+  if (!font.isInitialized()) return 0;
+
+  std::ostringstream output;
+  ReportWriter       writer(output);
+  bool               backup = font.getFontFormat() == FontFormat::BACKUP;
+
+  if (font.getFontFormat() == FontFormat::UTF32) font.showPlanes(writer, '<');
+
+  for (int faceIdx = 0; faceIdx < font.getPreamble().faceCount; faceIdx++) {
+    IBMFFontDiff::FacePtr face = font.getFace(faceIdx);
+    if (!font.prepareFace(*face)) continue;
+
+    font.showFaceHeader(writer, '<', face);
+
+    int                    glyphCount = face->header->glyphCount;
+    std::vector<GlyphCode> glyphCodes;
+
+    for (int glyphCode = 0; glyphCode < glyphCount; glyphCode++) {
+      char32_t codePoint = font.getUTF32(glyphCode);
+      font.translate(codePoint);
+      font.showBitmap(writer, '<', face->getBitmap(glyphCode));
+      glyphCodes.push_back(glyphCode);
+
+      if (!backup) {
+        const GlyphInfo *glyphInfo;
+        BitmapPtr        bitmap;
+        GlyphLigKernView glyphLigKern;
+        if (font.getGlyph(faceIdx, glyphCode, glyphInfo, bitmap, glyphLigKern)) {
+          font.showGlyphInfo(writer, '<', glyphCode, *glyphInfo);
+          font.showLigKerns(writer, '<', glyphLigKern);
+        }
+
+        GlyphCode next = (glyphCode + 1) % glyphCount;
+        FIX16     kern;
+        bool      kernPairPresent;
+        font.ligKern(faceIdx, glyphCode, &next, &kern, &kernPairPresent);
+      }
+    }
+
+    if (!backup) {
+      std::vector<FIX16> kerns(glyphCodes.size());
+      font.getKerns(faceIdx, glyphCodes.data(), glyphCodes.size(), kerns.data());
+      font.getLigKernPairs(*face);
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,172 @@
+#include "BatchDiff.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "FontDiffEngine.hpp"
+
+namespace fs = std::filesystem;
+
+auto BatchDiff::loadFont(const std::string &filename, std::ostream &errors,
+                         FingerprintCache *cache, bool streaming) -> IBMFFontDiffPtr {
+  MappedFilePtr file = MappedFilePtr(new MappedFile(filename.c_str()));
+  if (!file->isMapped()) {
+    errors << "Unable to open file " << filename << std::endl;
+    return nullptr;
+  }
+
+  IBMFFontDiff::Fingerprints fingerprints;
+  bool                       useCache = (cache != nullptr) && cache->isUsable();
+  bool                       cached   = useCache && cache->load(filename, *file, fingerprints);
+
+  auto font = IBMFFontDiffPtr(new IBMFFontDiff(file, !cached, streaming));
+  if ((font.get() == nullptr) || !font->isInitialized() ||
+      (font->getPreamble().bits.fontFormat != FontFormat::UTF32)) {
+    errors << "File " << filename << " is not of an appropriate IBMF format." << std::endl;
+    return nullptr;
+  }
+
+  if (cached && !font->setFingerprints(std::move(fingerprints))) {
+    font->computeHashes();
+    cached = false;
+  }
+  if (useCache && !cached) {
+    cache->save(filename, *file, font->getFingerprints());
+  }
+
+  return font;
+}
+
+auto BatchDiff::addFont(const std::string &path, FontSet &fonts) -> void {
+  std::string name = fs::path(path).filename().string();
+
+  if (!fonts.emplace(name, path).second) {
+    std::cerr << "Duplicate font name " << name << ", " << path << " ignored." << std::endl;
+  }
+}
+
+auto BatchDiff::readDirectory(const std::string &dir, FontSet &fonts) -> bool {
+  std::error_code error;
+
+  for (const auto &entry : fs::directory_iterator(dir, error)) {
+    if (entry.is_regular_file() && (entry.path().extension() == ".ibmf")) {
+      addFont(entry.path().string(), fonts);
+    }
+  }
+  if (error) {
+    std::cerr << "Unable to read directory " << dir << ": " << error.message() << std::endl;
+    return false;
+  }
+  return true;
+}
+
+auto BatchDiff::readManifest(const std::string &list, FontSet &fonts) -> bool {
+  std::ifstream file(list);
+  if (!file) {
+    std::cerr << "Unable to open manifest " << list << std::endl;
+    return false;
+  }
+
+  std::string line;
+  while (std::getline(file, line)) {
+    if (!line.empty() && (line.back() == '\r')) line.pop_back();
+    if (line.empty() || (line[0] == '#')) continue;
+    addFont(line, fonts);
+  }
+  return true;
+}
+
+auto BatchDiff::addDirectories(const std::string &dir1, const std::string &dir2) -> bool {
+  return readDirectory(dir1, fonts1_) && readDirectory(dir2, fonts2_);
+}
+
+auto BatchDiff::addManifests(const std::string &list1, const std::string &list2) -> bool {
+  return readManifest(list1, fonts1_) && readManifest(list2, fonts2_);
+}
+
+// The fonts are released as soon as their pair has been compared.
+auto BatchDiff::comparePair(const std::string &path1, const std::string &path2,
+                            const DiffReporter &reporter) const -> PairResult {
+  std::ostringstream errors;
+  IBMFFontDiffPtr    font1 = loadFont(path1, errors, cache_, options_.streaming);
+  IBMFFontDiffPtr    font2 = loadFont(path2, errors, cache_, options_.streaming);
+
+  if ((font1 == nullptr) || (font2 == nullptr)) {
+    return PairResult{.output = errors.str(), .diffCount = 0, .loaded = false};
+  }
+
+  PairResult      result{.output = {}, .diffCount = 0, .loaded = true};
+  DiffReporterPtr pairReporter = reporter.create(result.output);
+  pairReporter->nextPair();
+  pairReporter->begin(path1, path2);
+
+  FontDiffEngine engine(font1, font2, pool_, options_);
+  result.diffCount = engine.run(*pairReporter);
+
+  pairReporter->end(result.diffCount);
+
+  return result;
+}
+
+auto BatchDiff::run(DiffReporter &reporter) -> int {
+  std::vector<std::string> names;
+
+  for (auto &font : fonts1_) {
+    if (fonts2_.find(font.first) != fonts2_.end()) names.push_back(font.first);
+  }
+
+  DiffSummary summary = {};
+  size_t      window  = std::max(1u, pool_.getThreadCount()) * PAIRS_PER_THREAD;
+
+  for (size_t firstIdx = 0; firstIdx < names.size(); firstIdx += window) {
+    int count = std::min(window, names.size() - firstIdx);
+
+    // Each pair runs its own face and glyph tasks on the same pool.
+    std::vector<PairResult> results(count);
+    ThreadPool::TaskGroup   group;
+
+    for (int idx = 0; idx < count; idx++) {
+      pool_.run(group, [this, idx, firstIdx, &names, &results, &reporter]() {
+        const std::string &name = names[firstIdx + idx];
+        results[idx]            = comparePair(fonts1_.at(name), fonts2_.at(name), reporter);
+      });
+    }
+    pool_.wait(group);
+
+    for (auto &result : results) {
+      if (result.loaded) {
+        reporter.append(result.output);
+        summary.pairsCompared += 1;
+        summary.diffCount += result.diffCount;
+        if (result.diffCount > 0) {
+          summary.differentPairs += 1;
+        } else {
+          summary.identicalPairs += 1;
+        }
+      } else {
+        std::cerr << result.output;
+        summary.failedPairs += 1;
+      }
+    }
+  }
+
+  for (auto &font : fonts1_) {
+    if (fonts2_.find(font.first) == fonts2_.end()) {
+      reporter.fontNotPaired('<', font.second);
+      summary.unpairedFonts += 1;
+    }
+  }
+  for (auto &font : fonts2_) {
+    if (fonts1_.find(font.first) == fonts1_.end()) {
+      reporter.fontNotPaired('>', font.second);
+      summary.unpairedFonts += 1;
+    }
+  }
+
+  reporter.summary(summary);
+
+  return summary.diffCount;
+}
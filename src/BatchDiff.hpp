@@ -0,0 +1,71 @@
+#pragma once
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "DiffReporter.hpp"
+#include "FingerprintCache.hpp"
+#include "FontDiffEngine.hpp"
+#include "IBMFFontDiff.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * @brief Comparison of two sets of IBMF fonts.
+ *
+ * The fonts of both sets are paired by file name. A set is either the content
+ * of a directory (files with the .ibmf extension) or a manifest file listing
+ * one font path per line. Every pair of fonts is loaded and compared as a task
+ * of the shared thread pool, a few pairs per thread at a time. The reports are
+ * written in the order of the file names, followed by an aggregated summary.
+ *
+ */
+class BatchDiff {
+public:
+  static constexpr int PAIRS_PER_THREAD = 2; // Pairs compared at a time, for each thread
+
+  BatchDiff(ThreadPool &pool, FingerprintCache *cache = nullptr,
+            DiffOptions options = DiffOptions())
+      : pool_(pool), cache_(cache), options_(options) {}
+
+  // Retrieves the fonts of a set from a directory. Returns false if the directory
+  // cannot be read.
+  auto addDirectories(const std::string &dir1, const std::string &dir2) -> bool;
+
+  // Retrieves the fonts of a set from a manifest file. Empty lines and lines
+  // starting with a '#' are ignored. Returns false if a manifest cannot be read.
+  auto addManifests(const std::string &list1, const std::string &list2) -> bool;
+
+  // Compares all pairs of fonts, sending the reports and the summary to reporter.
+  // Returns the total number of differences found.
+  auto run(DiffReporter &reporter) -> int;
+
+  // Loads a font, writing to errors the reason of a failure. Returns nullptr if
+  // the font cannot be used. The fingerprints are retrieved from or saved to
+  // cache when not nullptr.
+  static auto loadFont(const std::string &filename, std::ostream &errors,
+                       FingerprintCache *cache = nullptr, bool streaming = false)
+      -> IBMFFontDiffPtr;
+
+private:
+  typedef std::map<std::string, std::string> FontSet; // file name -> path
+
+  struct PairResult {
+    std::string output; // Report, or load errors if not loaded
+    int         diffCount;
+    bool        loaded;
+  };
+
+  ThreadPool       &pool_;
+  FingerprintCache *cache_;
+  DiffOptions       options_;
+  FontSet           fonts1_, fonts2_;
+
+  static auto readDirectory(const std::string &dir, FontSet &fonts) -> bool;
+  static auto readManifest(const std::string &list, FontSet &fonts) -> bool;
+  static auto addFont(const std::string &path, FontSet &fonts) -> void;
+
+  auto comparePair(const std::string &path1, const std::string &path2,
+                   const DiffReporter &reporter) const -> PairResult;
+};
@@ -0,0 +1,66 @@
+#include "BinaryReporter.hpp"
+
+auto BinaryReporter::create(std::string &output) const -> DiffReporterPtr {
+  return DiffReporterPtr(new BinaryReporter(output));
+}
+
+auto BinaryReporter::writeInt32(int32_t value) -> void {
+  uint32_t v        = value;
+  char     bytes[4] = {char(v), char(v >> 8), char(v >> 16), char(v >> 24)};
+  stream_.write(bytes, 4);
+}
+
+auto BinaryReporter::writeString(const std::string &str) -> void {
+  uint16_t length   = (str.size() > 0xFFFF) ? 0xFFFF : str.size();
+  char     bytes[2] = {char(length), char(length >> 8)};
+  stream_.write(bytes, 2);
+  stream_.write(str.data(), length);
+}
+
+auto BinaryReporter::writeHeader(DiffKind kind, char side, uint8_t pointSize, uint8_t deltaCount,
+                                 char32_t codePoint, int32_t count) -> void {
+  char bytes[4] = {char(kind), side, char(pointSize), char(deltaCount)};
+  stream_.write(bytes, 4);
+  writeInt32(codePoint);
+  writeInt32(count);
+}
+
+auto BinaryReporter::begin(const std::string &path1, const std::string &path2) -> void {
+  writeHeader(DiffKind::BEGIN, 0, 0, 0, 0, 0);
+  writeString(path1);
+  writeString(path2);
+}
+
+auto BinaryReporter::end(int diffCount) -> void {
+  writeHeader(DiffKind::END, 0, 0, 0, 0, diffCount);
+}
+
+auto BinaryReporter::fontNotPaired(char side, const std::string &path) -> void {
+  writeHeader(DiffKind::FONT_NOT_PAIRED, side, 0, 0, 0, 0);
+  writeString(path);
+}
+
+auto BinaryReporter::summary(const DiffSummary &summary) -> void {
+  writeHeader(DiffKind::SUMMARY, 0, 0, 0, 0, summary.diffCount);
+  writeInt32(summary.pairsCompared);
+  writeInt32(summary.identicalPairs);
+  writeInt32(summary.differentPairs);
+  writeInt32(summary.failedPairs);
+  writeInt32(summary.unpairedFonts);
+}
+
+auto BinaryReporter::writeRecord(const DiffRecord &record) -> void {
+  bool pair = (record.kind == DiffKind::LIG_KERN_PAIR_ADDED) ||
+              (record.kind == DiffKind::LIG_KERN_PAIR_REMOVED) ||
+              (record.kind == DiffKind::LIG_KERN_PAIR_CHANGED);
+
+  writeHeader(record.kind, record.side, record.pointSize, record.deltas.size(), record.codePoint,
+              pair ? int32_t(record.nextCodePoint) : record.count);
+
+  for (auto &delta : record.deltas) {
+    char field = char(delta.field);
+    stream_.write(&field, 1);
+    writeInt32(delta.value1);
+    writeInt32(delta.value2);
+  }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "DiffReporter.hpp"
+
+/**
+ * @brief Compact binary report.
+ *
+ * The report is a sequence of records. All values are little-endian. Each
+ * record starts with a 12 bytes header:
+ *
+ *   uint8_t  kind        DiffKind
+ *   uint8_t  side        '<', '>' or 0
+ *   uint8_t  pointSize   0 if not related to a face
+ *   uint8_t  deltaCount  Number of field deltas following the header
+ *   uint32_t codePoint   0 if not related to a glyph
+ *   int32_t  count       changedPixels (GLYPH_PIXELS), changedSteps (GLYPH_LIG_KERN),
+ *                        nextCodePoint (LIG_KERN_PAIR kinds) or diffCount (END,
+ *                        SUMMARY), 0 otherwise
+ *
+ * followed by deltaCount field deltas of 9 bytes:
+ *
+ *   uint8_t  field       DiffField
+ *   int32_t  value1      Value in the first font (FIX16 fields in 1/64th)
+ *   int32_t  value2      Value in the second font
+ *
+ * BEGIN records are followed by the paths of both fonts and FONT_NOT_PAIRED
+ * records by the path of the font, as uint16_t length and characters. SUMMARY
+ * records are followed by the pairsCompared, identicalPairs, differentPairs,
+ * failedPairs and unpairedFonts counts as int32_t.
+ *
+ */
+class BinaryReporter : public RecordReporter {
+public:
+  BinaryReporter(std::ostream &stream) : RecordReporter(stream) {}
+  BinaryReporter(std::string &output) : RecordReporter(output) {}
+
+  auto create(std::string &output) const -> DiffReporterPtr override;
+
+  auto begin(const std::string &path1, const std::string &path2) -> void override;
+  auto end(int diffCount) -> void override;
+
+  auto fontNotPaired(char side, const std::string &path) -> void override;
+  auto summary(const DiffSummary &summary) -> void override;
+
+protected:
+  auto writeRecord(const DiffRecord &record) -> void override;
+
+private:
+  auto writeHeader(DiffKind kind, char side, uint8_t pointSize, uint8_t deltaCount,
+                   char32_t codePoint, int32_t count) -> void;
+  auto writeInt32(int32_t value) -> void;
+  auto writeString(const std::string &str) -> void;
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @brief 64 bits content hash.
+ *
+ * Incremental hash of a sequence of values, using the mixing steps and
+ * final avalanche of xxHash64. The result depends on the values and on the way
+ * they are added: the same sequence of add() calls always gives the same hash,
+ * from one run to another.
+ *
+ */
+class ContentHash {
+public:
+  ContentHash(uint64_t seed = 0) : hash_(seed + PRIME_5), length_(0) {}
+
+  inline auto add(const void *data, size_t size) -> ContentHash & {
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+
+    length_ += size;
+    for (; size >= 8; bytes += 8, size -= 8) {
+      uint64_t k;
+      memcpy(&k, bytes, 8);
+      hash_ ^= round(k);
+      hash_ = rotl(hash_, 27) * PRIME_1 + PRIME_4;
+    }
+    if (size >= 4) {
+      uint32_t k;
+      memcpy(&k, bytes, 4);
+      hash_ ^= k * PRIME_1;
+      hash_ = rotl(hash_, 23) * PRIME_2 + PRIME_3;
+      bytes += 4;
+      size -= 4;
+    }
+    for (; size > 0; bytes++, size--) {
+      hash_ ^= *bytes * PRIME_5;
+      hash_ = rotl(hash_, 11) * PRIME_1;
+    }
+    return *this;
+  }
+
+  template <typename T> inline auto add(T value) -> ContentHash & {
+    static_assert(std::is_trivially_copyable<T>::value, "add() requires a plain value");
+    return add(&value, sizeof(T));
+  }
+
+  inline auto get() const -> uint64_t {
+    uint64_t h = hash_ + length_;
+    h ^= h >> 33;
+    h *= PRIME_2;
+    h ^= h >> 29;
+    h *= PRIME_3;
+    h ^= h >> 32;
+    return h;
+  }
+
+private:
+  static constexpr uint64_t PRIME_1 = 0x9E3779B185EBCA87ULL;
+  static constexpr uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+  static constexpr uint64_t PRIME_3 = 0x165667B19E3779F9ULL;
+  static constexpr uint64_t PRIME_4 = 0x85EBCA77C2B2AE63ULL;
+  static constexpr uint64_t PRIME_5 = 0x27D4EB2F165667C5ULL;
+
+  uint64_t hash_;
+  uint64_t length_;
+
+  static inline auto rotl(uint64_t value, int count) -> uint64_t {
+    return (value << count) | (value >> (64 - count));
+  }
+
+  static inline auto round(uint64_t k) -> uint64_t { return rotl(k * PRIME_2, 31) * PRIME_1; }
+};
@@ -0,0 +1,224 @@
+#include "DiffReporter.hpp"
+
+static constexpr struct {
+  const char *name;
+  bool        fixed;
+} fields[] = {
+    {"faceCount", false},
+    {"dpi", false},
+    {"lineHeight", false},
+    {"xHeight", true},
+    {"emSize", true},
+    {"slantCorrection", true},
+    {"descenderHeight", false},
+    {"spaceSize", false},
+    {"glyphCount", false},
+    {"ligKernStepCount", false},
+    {"pixelsPoolSize", false},
+    {"bitmapWidth", false},
+    {"bitmapHeight", false},
+    {"horizontalOffset", false},
+    {"verticalOffset", false},
+    {"packetLength", false},
+    {"advance", true},
+    {"dynF", false},
+    {"firstIsBlack", false},
+    {"beforeAddedOptKern", false},
+    {"afterAddedOptKern", false},
+    {"mainCode", false},
+    {"ligStepCount", false},
+    {"kernStepCount", false},
+    {"kern", true},
+    {"ligature", false},
+};
+
+static_assert(sizeof(fields) / sizeof(fields[0]) == int(DiffField::FIELD_COUNT),
+              "fields table out of sync with DiffField");
+
+auto DiffReporter::fieldName(DiffField field) -> const char * { return fields[int(field)].name; }
+
+auto DiffReporter::isFixedField(DiffField field) -> bool { return fields[int(field)].fixed; }
+
+static inline auto addDelta(FieldDeltas &deltas, DiffField field, int32_t value1, int32_t value2)
+    -> void {
+  if (value1 != value2) deltas.push_back(FieldDelta{field, value1, value2});
+}
+
+auto DiffReporter::faceHeaderDeltas(const FaceHeader &header1, const FaceHeader &header2)
+    -> FieldDeltas {
+  FieldDeltas deltas;
+
+  addDelta(deltas, DiffField::DPI, header1.dpi, header2.dpi);
+  addDelta(deltas, DiffField::LINE_HEIGHT, header1.lineHeight, header2.lineHeight);
+  addDelta(deltas, DiffField::X_HEIGHT, header1.xHeight, header2.xHeight);
+  addDelta(deltas, DiffField::EM_SIZE, header1.emSize, header2.emSize);
+  addDelta(deltas, DiffField::SLANT_CORRECTION, header1.slantCorrection, header2.slantCorrection);
+  addDelta(deltas, DiffField::DESCENDER_HEIGHT, header1.descenderHeight, header2.descenderHeight);
+  addDelta(deltas, DiffField::SPACE_SIZE, header1.spaceSize, header2.spaceSize);
+  addDelta(deltas, DiffField::GLYPH_COUNT, header1.glyphCount, header2.glyphCount);
+  addDelta(deltas, DiffField::LIG_KERN_STEP_COUNT, header1.ligKernStepCount,
+           header2.ligKernStepCount);
+  addDelta(deltas, DiffField::PIXELS_POOL_SIZE, header1.pixelsPoolSize, header2.pixelsPoolSize);
+
+  return deltas;
+}
+
+// Only the fields considered by GlyphInfo::operator==() are reported.
+auto DiffReporter::glyphMetricsDeltas(const GlyphInfo &glyph1, const GlyphInfo &glyph2)
+    -> FieldDeltas {
+  FieldDeltas deltas;
+
+  addDelta(deltas, DiffField::BITMAP_WIDTH, glyph1.bitmapWidth, glyph2.bitmapWidth);
+  addDelta(deltas, DiffField::BITMAP_HEIGHT, glyph1.bitmapHeight, glyph2.bitmapHeight);
+  addDelta(deltas, DiffField::HORIZONTAL_OFFSET, glyph1.horizontalOffset,
+           glyph2.horizontalOffset);
+  addDelta(deltas, DiffField::VERTICAL_OFFSET, glyph1.verticalOffset, glyph2.verticalOffset);
+  addDelta(deltas, DiffField::PACKET_LENGTH, glyph1.packetLength, glyph2.packetLength);
+  addDelta(deltas, DiffField::ADVANCE, glyph1.advance, glyph2.advance);
+  addDelta(deltas, DiffField::DYN_F, glyph1.rleMetrics.dynF, glyph2.rleMetrics.dynF);
+  addDelta(deltas, DiffField::FIRST_IS_BLACK, glyph1.rleMetrics.firstIsBlack,
+           glyph2.rleMetrics.firstIsBlack);
+  addDelta(deltas, DiffField::BEFORE_ADDED_OPT_KERN, glyph1.rleMetrics.beforeAddedOptKern,
+           glyph2.rleMetrics.beforeAddedOptKern);
+  addDelta(deltas, DiffField::AFTER_ADDED_OPT_KERN, glyph1.rleMetrics.afterAddedOptKern,
+           glyph2.rleMetrics.afterAddedOptKern);
+  addDelta(deltas, DiffField::MAIN_CODE, glyph1.mainCode, glyph2.mainCode);
+
+  return deltas;
+}
+
+auto DiffReporter::ligKernDeltas(const GlyphLigKernView &ligKern1,
+                                 const GlyphLigKernView &ligKern2) -> FieldDeltas {
+  FieldDeltas deltas;
+
+  addDelta(deltas, DiffField::LIG_STEP_COUNT, ligKern1.ligSteps.size(), ligKern2.ligSteps.size());
+  addDelta(deltas, DiffField::KERN_STEP_COUNT, ligKern1.kernSteps.size(),
+           ligKern2.kernSteps.size());
+
+  return deltas;
+}
+
+auto DiffReporter::ligKernPairDeltas(const IBMFFontDiff::LigKernPair *pair1,
+                                     const IBMFFontDiff::LigKernPair *pair2) -> FieldDeltas {
+  const IBMFFontDiff::LigKernPair &pair  = (pair1 != nullptr) ? *pair1 : *pair2;
+  DiffField                        field = pair.ligature ? DiffField::LIGATURE : DiffField::KERN;
+
+  return FieldDeltas{FieldDelta{field, (pair1 != nullptr) ? pair1->value : 0,
+                                (pair2 != nullptr) ? pair2->value : 0}};
+}
+
+auto RecordReporter::faceCountDiffer(int faceCount1, int faceCount2) -> void {
+  writeRecord(DiffRecord{.kind          = DiffKind::FACE_COUNT,
+                         .side          = 0,
+                         .pointSize     = 0,
+                         .codePoint     = 0,
+                         .nextCodePoint = 0,
+                         .count         = 0,
+                         .deltas = {FieldDelta{DiffField::FACE_COUNT, faceCount1, faceCount2}}});
+}
+
+auto RecordReporter::faceNotFound(char side, uint8_t pointSize) -> void {
+  writeRecord(DiffRecord{.kind          = DiffKind::FACE_NOT_FOUND,
+                         .side          = side,
+                         .pointSize     = pointSize,
+                         .codePoint     = 0,
+                         .nextCodePoint = 0,
+                         .count         = 0,
+                         .deltas        = {}});
+}
+
+auto RecordReporter::faceHeadersDiffer(const IBMFFontDiff &, IBMFFontDiff::FacePtr face1,
+                                       const IBMFFontDiff &, IBMFFontDiff::FacePtr face2)
+    -> void {
+  writeRecord(DiffRecord{.kind          = DiffKind::FACE_HEADER,
+                         .side          = 0,
+                         .pointSize     = face1->header->pointSize,
+                         .codePoint     = 0,
+                         .nextCodePoint = 0,
+                         .count         = 0,
+                         .deltas        = faceHeaderDeltas(*face1->header, *face2->header)});
+}
+
+auto RecordReporter::glyphMetricsDiffer(char32_t codePoint, const GlyphRef &glyph1,
+                                        const GlyphRef &glyph2) -> void {
+  writeRecord(DiffRecord{.kind          = DiffKind::GLYPH_METRICS,
+                         .side          = 0,
+                         .pointSize     = glyph1.face.header->pointSize,
+                         .codePoint     = codePoint,
+                         .nextCodePoint = 0,
+                         .count         = 0,
+                         .deltas = glyphMetricsDeltas(glyph1.face.glyphs[glyph1.glyphCode],
+                                                      glyph2.face.glyphs[glyph2.glyphCode])});
+}
+
+auto RecordReporter::glyphPixelsDiffer(char32_t codePoint, const GlyphRef &glyph1,
+                                       const GlyphRef &glyph2) -> void {
+  BitmapPtr bitmap1 = glyph1.face.getBitmap(glyph1.glyphCode);
+  BitmapPtr bitmap2 = glyph2.face.getBitmap(glyph2.glyphCode);
+
+  FieldDeltas deltas;
+  addDelta(deltas, DiffField::BITMAP_WIDTH, bitmap1->dim.width, bitmap2->dim.width);
+  addDelta(deltas, DiffField::BITMAP_HEIGHT, bitmap1->dim.height, bitmap2->dim.height);
+
+  writeRecord(DiffRecord{.kind          = DiffKind::GLYPH_PIXELS,
+                         .side          = 0,
+                         .pointSize     = glyph1.face.header->pointSize,
+                         .codePoint     = codePoint,
+                         .nextCodePoint = 0,
+                         .count         = bitmap1->difference(*bitmap2),
+                         .deltas        = std::move(deltas)});
+}
+
+auto RecordReporter::glyphLigKernDiffer(char32_t codePoint, const GlyphRef &glyph1,
+                                        const GlyphRef &glyph2) -> void {
+  const GlyphLigKernView &ligKern1 = glyph1.face.glyphsLigKern[glyph1.glyphCode];
+  const GlyphLigKernView &ligKern2 = glyph2.face.glyphsLigKern[glyph2.glyphCode];
+
+  int32_t count = 0;
+  if ((ligKern1.ligSteps.size() == ligKern2.ligSteps.size()) &&
+      (ligKern1.kernSteps.size() == ligKern2.kernSteps.size())) {
+    for (size_t idx = 0; idx < ligKern1.ligSteps.size(); idx++) {
+      if (!(ligKern1.ligSteps[idx] == ligKern2.ligSteps[idx])) count += 1;
+    }
+    for (size_t idx = 0; idx < ligKern1.kernSteps.size(); idx++) {
+      if (!(ligKern1.kernSteps[idx] == ligKern2.kernSteps[idx])) count += 1;
+    }
+  } else {
+    count = -1;
+  }
+
+  writeRecord(DiffRecord{.kind          = DiffKind::GLYPH_LIG_KERN,
+                         .side          = 0,
+                         .pointSize     = glyph1.face.header->pointSize,
+                         .codePoint     = codePoint,
+                         .nextCodePoint = 0,
+                         .count         = count,
+                         .deltas        = ligKernDeltas(ligKern1, ligKern2)});
+}
+
+auto RecordReporter::codePointNotFound(char side, uint8_t pointSize, char32_t codePoint) -> void {
+  writeRecord(DiffRecord{.kind          = DiffKind::CODE_POINT_NOT_FOUND,
+                         .side          = side,
+                         .pointSize     = pointSize,
+                         .codePoint     = codePoint,
+                         .nextCodePoint = 0,
+                         .count         = 0,
+                         .deltas        = {}});
+}
+
+auto RecordReporter::ligKernPairDiffer(uint8_t pointSize, const IBMFFontDiff::LigKernPair *pair1,
+                                       const IBMFFontDiff::LigKernPair *pair2) -> void {
+  const IBMFFontDiff::LigKernPair &pair = (pair1 != nullptr) ? *pair1 : *pair2;
+
+  DiffKind kind = (pair1 == nullptr)   ? DiffKind::LIG_KERN_PAIR_ADDED
+                  : (pair2 == nullptr) ? DiffKind::LIG_KERN_PAIR_REMOVED
+                                       : DiffKind::LIG_KERN_PAIR_CHANGED;
+
+  writeRecord(DiffRecord{.kind          = kind,
+                         .side          = 0,
+                         .pointSize     = pointSize,
+                         .codePoint     = pair.codePoint,
+                         .nextCodePoint = pair.nextCodePoint,
+                         .count         = 0,
+                         .deltas        = ligKernPairDeltas(pair1, pair2)});
+}
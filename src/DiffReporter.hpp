@@ -0,0 +1,231 @@
+#pragma once
+
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "IBMFFontDiff.hpp"
+
+// Kind of the reported differences, as stored in the structured reports.
+enum class DiffKind : uint8_t {
+  BEGIN,                  // Start of the comparison of two fonts
+  END,                    // End of the comparison, with the number of differences
+  FACE_COUNT,             // Number of faces differ
+  FACE_NOT_FOUND,         // Face of a point size is missing in a font
+  FACE_HEADER,            // Face headers differ
+  GLYPH_METRICS,          // Glyph metrics differ
+  GLYPH_PIXELS,           // Glyph bitmaps differ
+  GLYPH_LIG_KERN,         // Glyph ligature/kerning steps differ
+  CODE_POINT_NOT_FOUND,   // CodePoint is missing in a font
+  FONT_NOT_PAIRED,        // Batch mode: font without a counterpart
+  SUMMARY,                // Batch mode: aggregated counts
+  LIG_KERN_PAIR_ADDED,    // Pairs mode: ligature/kerning pair only in the second font
+  LIG_KERN_PAIR_REMOVED,  // Pairs mode: ligature/kerning pair only in the first font
+  LIG_KERN_PAIR_CHANGED,  // Pairs mode: ligature/kerning pair with another value
+  KIND_COUNT
+};
+
+// Compared fields of the face headers and glyphs. The FIX16 fields are in 1/64th.
+enum class DiffField : uint8_t {
+  FACE_COUNT,
+  DPI,
+  LINE_HEIGHT,
+  X_HEIGHT,
+  EM_SIZE,
+  SLANT_CORRECTION,
+  DESCENDER_HEIGHT,
+  SPACE_SIZE,
+  GLYPH_COUNT,
+  LIG_KERN_STEP_COUNT,
+  PIXELS_POOL_SIZE,
+  BITMAP_WIDTH,
+  BITMAP_HEIGHT,
+  HORIZONTAL_OFFSET,
+  VERTICAL_OFFSET,
+  PACKET_LENGTH,
+  ADVANCE,
+  DYN_F,
+  FIRST_IS_BLACK,
+  BEFORE_ADDED_OPT_KERN,
+  AFTER_ADDED_OPT_KERN,
+  MAIN_CODE,
+  LIG_STEP_COUNT,
+  KERN_STEP_COUNT,
+  KERN,
+  LIGATURE,
+  FIELD_COUNT
+};
+
+struct FieldDelta {
+  DiffField field;
+  int32_t   value1, value2;
+};
+
+typedef std::vector<FieldDelta> FieldDeltas;
+
+// Batch mode counts
+struct DiffSummary {
+  int pairsCompared;
+  int identicalPairs;
+  int differentPairs;
+  int failedPairs;
+  int unpairedFonts;
+  int diffCount;
+};
+
+class DiffReporter;
+
+typedef std::unique_ptr<DiffReporter> DiffReporterPtr;
+
+// Output stream appending to a string, without any intermediate buffer.
+class StringStream {
+public:
+  StringStream(std::string &output) : buffer_(output), stream_(&buffer_) {}
+
+  inline auto stream() -> std::ostream & { return stream_; }
+
+private:
+  class Buffer : public std::streambuf {
+  public:
+    Buffer(std::string &output) : output_(output) {}
+
+  protected:
+    auto overflow(int ch) -> int override {
+      if (ch != traits_type::eof()) output_.push_back(char(ch));
+      return ch;
+    }
+    auto xsputn(const char *str, std::streamsize count) -> std::streamsize override {
+      output_.append(str, count);
+      return count;
+    }
+
+  private:
+    std::string &output_;
+  };
+
+  Buffer       buffer_;
+  std::ostream stream_;
+};
+
+/**
+ * @brief Output backend of the font comparison.
+ *
+ * The comparison engine reports every difference found through one of the
+ * following methods. The reporters write them as they come: nothing is kept in
+ * memory.
+ *
+ * The side parameters are '<' for the first font and '>' for the second font.
+ * For the not found methods, it identifies the font where the face or codePoint
+ * is missing.
+ *
+ */
+class DiffReporter {
+public:
+  struct GlyphRef {
+    const IBMFFontDiff &font;
+    IBMFFontDiff::Face &face;
+    GlyphCode           glyphCode;
+  };
+
+  DiffReporter(std::ostream &stream) : stream_(stream) {}
+  DiffReporter(std::string &output)
+      : stringStream_(new StringStream(output)), stream_(stringStream_->stream()) {}
+  virtual ~DiffReporter() {}
+
+  // Returns a reporter of the same format appending to a string. Used by the
+  // concurrent tasks of a comparison, their output being appended later to this
+  // reporter's stream. The string keeps its capacity from one task to the next.
+  virtual auto create(std::string &output) const -> DiffReporterPtr = 0;
+
+  // Appends the output of a reporter created with create().
+  virtual auto append(const std::string &output) -> void { stream_ << output; }
+
+  virtual auto begin(const std::string &path1, const std::string &path2) -> void = 0;
+  virtual auto end(int diffCount) -> void                                        = 0;
+
+  virtual auto faceCountDiffer(int faceCount1, int faceCount2) -> void = 0;
+  virtual auto faceNotFound(char side, uint8_t pointSize) -> void      = 0;
+  virtual auto faceHeadersDiffer(const IBMFFontDiff &font1, IBMFFontDiff::FacePtr face1,
+                                 const IBMFFontDiff &font2, IBMFFontDiff::FacePtr face2)
+      -> void = 0;
+
+  virtual auto glyphMetricsDiffer(char32_t codePoint, const GlyphRef &glyph1,
+                                  const GlyphRef &glyph2) -> void  = 0;
+  virtual auto glyphPixelsDiffer(char32_t codePoint, const GlyphRef &glyph1,
+                                 const GlyphRef &glyph2) -> void   = 0;
+  virtual auto glyphLigKernDiffer(char32_t codePoint, const GlyphRef &glyph1,
+                                  const GlyphRef &glyph2) -> void  = 0;
+  virtual auto codePointNotFound(char side, uint8_t pointSize, char32_t codePoint) -> void = 0;
+
+  // Pairs mode only: the ligature/kerning pairs are compared for the whole face. pair1
+  // is nullptr for an added pair, pair2 is nullptr for a removed pair.
+  virtual auto ligKernPairDiffer(uint8_t pointSize, const IBMFFontDiff::LigKernPair *pair1,
+                                 const IBMFFontDiff::LigKernPair *pair2) -> void = 0;
+
+  // Batch mode only
+  virtual auto nextPair() -> void {}
+  virtual auto fontNotPaired(char side, const std::string &path) -> void = 0;
+  virtual auto summary(const DiffSummary &summary) -> void               = 0;
+
+  static auto fieldName(DiffField field) -> const char *;
+  static auto isFixedField(DiffField field) -> bool;
+
+  static auto faceHeaderDeltas(const FaceHeader &header1, const FaceHeader &header2)
+      -> FieldDeltas;
+  static auto glyphMetricsDeltas(const GlyphInfo &glyph1, const GlyphInfo &glyph2) -> FieldDeltas;
+  static auto ligKernDeltas(const GlyphLigKernView &ligKern1, const GlyphLigKernView &ligKern2)
+      -> FieldDeltas;
+  static auto ligKernPairDeltas(const IBMFFontDiff::LigKernPair *pair1,
+                                const IBMFFontDiff::LigKernPair *pair2) -> FieldDeltas;
+
+protected:
+  std::unique_ptr<StringStream> stringStream_; // Reporters created to write to a string
+  std::ostream                 &stream_;
+};
+
+/**
+ * @brief Base of the structured reporters.
+ *
+ * The face and glyph differences are converted to DiffRecord entries, with the
+ * fields that differ. For GLYPH_PIXELS, count is the number of changed pixels,
+ * or -1 when the bitmaps dimensions differ. For GLYPH_LIG_KERN, count is the
+ * number of steps that differ, or -1 when the number of steps differ. For the
+ * LIG_KERN_PAIR kinds, codePoint and nextCodePoint identify the pair, the deltas
+ * giving its kern or ligature value in both fonts (0 in the font without the pair).
+ *
+ */
+class RecordReporter : public DiffReporter {
+public:
+  struct DiffRecord {
+    DiffKind    kind;
+    char        side;
+    uint8_t     pointSize;
+    char32_t    codePoint;
+    char32_t    nextCodePoint;
+    int32_t     count;
+    FieldDeltas deltas;
+  };
+
+  RecordReporter(std::ostream &stream) : DiffReporter(stream) {}
+  RecordReporter(std::string &output) : DiffReporter(output) {}
+
+  auto faceCountDiffer(int faceCount1, int faceCount2) -> void override;
+  auto faceNotFound(char side, uint8_t pointSize) -> void override;
+  auto faceHeadersDiffer(const IBMFFontDiff &font1, IBMFFontDiff::FacePtr face1,
+                         const IBMFFontDiff &font2, IBMFFontDiff::FacePtr face2) -> void override;
+
+  auto glyphMetricsDiffer(char32_t codePoint, const GlyphRef &glyph1, const GlyphRef &glyph2)
+      -> void override;
+  auto glyphPixelsDiffer(char32_t codePoint, const GlyphRef &glyph1, const GlyphRef &glyph2)
+      -> void override;
+  auto glyphLigKernDiffer(char32_t codePoint, const GlyphRef &glyph1, const GlyphRef &glyph2)
+      -> void override;
+  auto codePointNotFound(char side, uint8_t pointSize, char32_t codePoint) -> void override;
+  auto ligKernPairDiffer(uint8_t pointSize, const IBMFFontDiff::LigKernPair *pair1,
+                         const IBMFFontDiff::LigKernPair *pair2) -> void override;
+
+protected:
+  virtual auto writeRecord(const DiffRecord &record) -> void = 0;
+};
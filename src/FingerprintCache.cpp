@@ -0,0 +1,169 @@
+#include "FingerprintCache.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#include <unistd.h>
+
+#include "ContentHash.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Absolute path of a font, naming its entry
+auto normalize(const std::string &path) -> std::string {
+  std::error_code error;
+  fs::path        absolute = fs::absolute(path, error);
+  return (error ? fs::path(path) : absolute).lexically_normal().string();
+}
+
+template <typename T> auto readValue(std::ifstream &input, T &value) -> bool {
+  return bool(input.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+
+template <typename T> auto writeValue(std::ofstream &output, const T &value) -> void {
+  output.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+} // namespace
+
+FingerprintCache::FingerprintCache(const std::string &directory)
+    : directory_(directory), usable_(false) {
+  std::error_code error;
+
+  fs::create_directories(directory_, error);
+  if (error || !fs::is_directory(directory_, error)) {
+    std::cerr << "Unable to use cache directory " << directory_ << std::endl;
+    return;
+  }
+  usable_ = true;
+}
+
+auto FingerprintCache::getEntryName(const std::string &fontPath) const -> std::string {
+  ContentHash hash;
+  hash.add(reinterpret_cast<const uint8_t *>(fontPath.data()), fontPath.size());
+
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "%016llx.fp", (unsigned long long)hash.get());
+  return buffer;
+}
+
+auto FingerprintCache::load(const std::string &path, const MappedFile &file,
+                            IBMFFontDiff::Fingerprints &fingerprints) const -> bool {
+  if (!usable_) return false;
+
+  std::string   fontPath = normalize(path);
+  std::ifstream input(directory_ + "/" + getEntryName(fontPath), std::ios::binary);
+  if (!input) return false;
+
+  char        marker[sizeof(MARKER)];
+  Identity    identity;
+  uint32_t    pathLength;
+  std::string entryPath;
+  uint32_t    faceCount;
+
+  if (!input.read(marker, sizeof(marker)) || (memcmp(marker, MARKER, sizeof(MARKER)) != 0) ||
+      !readValue(input, identity.size) || !readValue(input, identity.modificationTime) ||
+      !readValue(input, identity.device) || !readValue(input, identity.inode) ||
+      !readValue(input, identity.contentHash) || !readValue(input, pathLength) ||
+      (pathLength > 4096)) {
+    return false;
+  }
+  entryPath.resize(pathLength);
+  if (!input.read(entryPath.data(), pathLength) || (entryPath != fontPath)) return false;
+
+  if ((identity.size != file.getSize()) ||
+      (identity.modificationTime != file.getModificationTime()) ||
+      (identity.device != file.getDevice()) || (identity.inode != file.getInode())) {
+    return false;
+  }
+  if (identity.contentHash != 0) {
+    ContentHash hash;
+    hash.add(file.getData(), file.getSize());
+    if (hash.get() != identity.contentHash) return false;
+  }
+
+  if (!readValue(input, faceCount) || (faceCount > 255)) return false;
+
+  fingerprints.resize(faceCount);
+  for (auto &face : fingerprints) {
+    uint16_t glyphCount;
+    if (!readValue(input, face.pointSize) || !readValue(input, glyphCount) ||
+        !readValue(input, face.hash)) {
+      return false;
+    }
+    face.glyphHashes.resize(glyphCount);
+    if (!input.read(reinterpret_cast<char *>(face.glyphHashes.data()),
+                    glyphCount * sizeof(uint64_t))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+auto FingerprintCache::save(const std::string &path, const MappedFile &file,
+                            const IBMFFontDiff::Fingerprints &fingerprints) const -> bool {
+  static std::atomic<unsigned> sequence(0);
+
+  if (!usable_) return false;
+
+  Identity identity{.size             = file.getSize(),
+                    .modificationTime = file.getModificationTime(),
+                    .device           = file.getDevice(),
+                    .inode            = file.getInode(),
+                    .contentHash      = 0};
+
+  int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::system_clock::now().time_since_epoch())
+                    .count();
+  if (now - identity.modificationTime < TIMESTAMP_GRANULARITY) {
+    ContentHash hash;
+    hash.add(file.getData(), file.getSize());
+    identity.contentHash = hash.get();
+  }
+
+  std::string fontPath = normalize(path);
+  std::string entry    = directory_ + "/" + getEntryName(fontPath);
+  std::string temp = entry + ".tmp-" + std::to_string(getpid()) + "-" + std::to_string(sequence++);
+  {
+    std::ofstream output(temp, std::ios::binary);
+    uint32_t      pathLength = fontPath.size();
+    uint32_t      faceCount  = fingerprints.size();
+
+    output.write(MARKER, sizeof(MARKER));
+    writeValue(output, identity.size);
+    writeValue(output, identity.modificationTime);
+    writeValue(output, identity.device);
+    writeValue(output, identity.inode);
+    writeValue(output, identity.contentHash);
+    writeValue(output, pathLength);
+    output.write(fontPath.data(), pathLength);
+    writeValue(output, faceCount);
+    for (auto &face : fingerprints) {
+      uint16_t glyphCount = face.glyphHashes.size();
+      writeValue(output, face.pointSize);
+      writeValue(output, glyphCount);
+      writeValue(output, face.hash);
+      output.write(reinterpret_cast<const char *>(face.glyphHashes.data()),
+                   glyphCount * sizeof(uint64_t));
+    }
+    if (!output.flush()) {
+      output.close();
+      std::remove(temp.c_str());
+      return false;
+    }
+  }
+
+  std::error_code error;
+  fs::rename(temp, entry, error);
+  if (error) {
+    std::remove(temp.c_str());
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+
+#include "IBMFFontDiff.hpp"
+#include "MappedFile.hpp"
+
+/**
+ * @brief On-disk cache of the font content hashes.
+ *
+ * The fingerprints of a font (face and glyph hashes) are saved in a file of the
+ * cache directory named from the font path, such that a new entry for a path
+ * replaces the previous one. The entry records the identity of the font file: its
+ * size, modification time and inode. A font whose file still has that identity is
+ * loaded without reading its content to compute its glyph hashes.
+ *
+ * A file modified within the timestamp granularity of the entry being saved could
+ * change again without its modification time changing. The entry then also records
+ * a hash of the whole file content, checked when the entry is loaded.
+ *
+ * Entries are written to a temporary file that is then renamed, such that
+ * concurrent runs sharing the same directory never see a partial entry.
+ * Unreadable or inconsistent entries are ignored.
+ *
+ */
+class FingerprintCache {
+public:
+  FingerprintCache(const std::string &directory);
+
+  inline auto isUsable() const -> bool { return usable_; }
+
+  // Retrieves the fingerprints of the font file mapped from path, if its entry is
+  // still valid for the file.
+  auto load(const std::string &path, const MappedFile &file,
+            IBMFFontDiff::Fingerprints &fingerprints) const -> bool;
+  // Replaces the entry of the font file mapped from path.
+  auto save(const std::string &path, const MappedFile &file,
+            const IBMFFontDiff::Fingerprints &fingerprints) const -> bool;
+
+private:
+  static constexpr char MARKER[8] = {'I', 'B', 'M', 'F', 'F', 'P', '0', '2'};
+
+  // Largest timestamp granularity of the usual file systems (FAT), in nanoseconds
+  static constexpr int64_t TIMESTAMP_GRANULARITY = 2000000000;
+
+  // Identity of a font file, at the start of its entry
+  struct Identity {
+    uint32_t size;
+    int64_t  modificationTime;
+    uint64_t device, inode;
+    uint64_t contentHash; // 0 when the modification time is not ambiguous
+  };
+
+  // Name of the entry of a font, from its absolute path
+  auto getEntryName(const std::string &fontPath) const -> std::string;
+
+  std::string directory_;
+  bool        usable_;
+};
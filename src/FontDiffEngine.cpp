@@ -0,0 +1,245 @@
+#include "FontDiffEngine.hpp"
+
+#include <algorithm>
+
+auto FontDiffEngine::run(DiffReporter &reporter) -> int {
+  diffCount_ = 0;
+
+  checkPreamble(reporter);
+  checkFaceHeaders(reporter);
+  checkGlyphs(reporter);
+
+  return diffCount_;
+}
+
+auto FontDiffEngine::checkPreamble(DiffReporter &reporter) -> void {
+  if (font1_->getPreamble().faceCount != font2_->getPreamble().faceCount) {
+    reporter.faceCountDiffer(font1_->getPreamble().faceCount, font2_->getPreamble().faceCount);
+    diffCount_ += 1;
+  }
+}
+
+auto FontDiffEngine::checkFaceHeaders(DiffReporter &reporter) -> void {
+  int faceIdx1, faceIdx2;
+
+  for (faceIdx1 = 0; faceIdx1 < font1_->getPreamble().faceCount; faceIdx1++) {
+    IBMFFontDiff::FacePtr face1 = font1_->getFace(faceIdx1);
+    IBMFFontDiff::FacePtr face2 = font2_->findFace(face1->header->pointSize);
+    if (face2 == nullptr) {
+      reporter.faceNotFound('>', face1->header->pointSize);
+      diffCount_ += 1;
+    } else {
+      if (!(*face1->header == *face2->header)) {
+        reporter.faceHeadersDiffer(*font1_, face1, *font2_, face2);
+        diffCount_ += 1;
+      }
+    }
+  }
+
+  for (faceIdx2 = 0; faceIdx2 < font2_->getPreamble().faceCount; faceIdx2++) {
+    IBMFFontDiff::FacePtr face2 = font2_->getFace(faceIdx2);
+    IBMFFontDiff::FacePtr face1 = font1_->findFace(face2->header->pointSize);
+    if (face1 == nullptr) {
+      reporter.faceNotFound('<', face2->header->pointSize);
+      diffCount_ += 1;
+    }
+  }
+}
+
+// Faces of the first font that are not present in the second font are skipped,
+// as already reported by checkFaceHeaders(). When a font is streamed, every pair of
+// faces is compared and released before the next one is prepared.
+auto FontDiffEngine::checkGlyphs(DiffReporter &reporter) -> void {
+  std::vector<Chunk> chunks;
+  bool               streaming = font1_->isStreaming() || font2_->isStreaming();
+
+  for (int faceIdx1 = 0; faceIdx1 < font1_->getPreamble().faceCount; faceIdx1++) {
+    IBMFFontDiff::FacePtr face1 = font1_->getFace(faceIdx1);
+    IBMFFontDiff::FacePtr face2 = font2_->findFace(face1->header->pointSize);
+
+    if (face2 == nullptr) continue;
+
+    // Identical faces: every glyph is found through its codePoint and has the same hash
+    if ((face1->hash == face2->hash) && font1_->mapsGlyphCodes(face1->header->glyphCount) &&
+        font2_->mapsGlyphCodes(face2->header->glyphCount)) {
+      continue;
+    }
+
+    if (font1_->prepareFace(*face1) && font2_->prepareFace(*face2)) {
+      addFaceChunks(face1, face2, chunks);
+    }
+
+    if (streaming) {
+      runChunks(chunks, reporter);
+      chunks.clear();
+      font1_->releaseFace(*face1);
+      font2_->releaseFace(*face2);
+    }
+  }
+
+  runChunks(chunks, reporter);
+}
+
+auto FontDiffEngine::addFaceChunks(IBMFFontDiff::FacePtr face1, IBMFFontDiff::FacePtr face2,
+                                   std::vector<Chunk> &chunks) const -> void {
+  int glyphCount1 = face1->header->glyphCount;
+  int glyphCount2 = face2->header->glyphCount;
+
+  for (int first = 0; first < glyphCount1; first += CHUNK_SIZE) {
+    GlyphCode last = std::min(first + CHUNK_SIZE, glyphCount1);
+    chunks.push_back(Chunk{.face1 = face1, .face2 = face2, .first = GlyphCode(first),
+                           .last = last, .kind = ChunkKind::GLYPHS});
+  }
+  for (int first = 0; first < glyphCount2; first += CHUNK_SIZE) {
+    GlyphCode last = std::min(first + CHUNK_SIZE, glyphCount2);
+    chunks.push_back(Chunk{.face1 = face1, .face2 = face2, .first = GlyphCode(first),
+                           .last = last, .kind = ChunkKind::MISSING});
+  }
+  if (options_.ligKernPairs) {
+    chunks.push_back(Chunk{.face1 = face1, .face2 = face2, .first = 0, .last = 0,
+                           .kind = ChunkKind::LIG_KERN_PAIRS});
+  }
+}
+
+auto FontDiffEngine::runChunks(const std::vector<Chunk> &chunks, DiffReporter &reporter)
+    -> void {
+  size_t window = std::max(1u, pool_.getThreadCount()) * CHUNKS_PER_THREAD;
+
+  // The chunk outputs are reused from one window to the next
+  std::vector<std::string> outputs(window);
+  std::vector<int>         diffCounts(window, 0);
+
+  for (size_t firstIdx = 0; firstIdx < chunks.size(); firstIdx += window) {
+    int                   count = std::min(window, chunks.size() - firstIdx);
+    ThreadPool::TaskGroup group;
+
+    for (int idx = 0; idx < count; idx++) {
+      pool_.run(group, [this, idx, firstIdx, &chunks, &outputs, &diffCounts, &reporter]() {
+        outputs[idx].clear();
+        DiffReporterPtr chunkReporter = reporter.create(outputs[idx]);
+        diffCounts[idx]               = checkChunk(chunks[firstIdx + idx], *chunkReporter);
+      });
+    }
+    pool_.wait(group);
+
+    for (int idx = 0; idx < count; idx++) {
+      reporter.append(outputs[idx]);
+      diffCount_ += diffCounts[idx];
+    }
+  }
+}
+
+auto FontDiffEngine::checkChunk(const Chunk &chunk, DiffReporter &reporter) const -> int {
+  switch (chunk.kind) {
+    case ChunkKind::GLYPHS:
+      return checkGlyphRange(chunk, reporter);
+    case ChunkKind::MISSING:
+      return checkMissingRange(chunk, reporter);
+    case ChunkKind::LIG_KERN_PAIRS:
+      return checkLigKernPairs(chunk, reporter);
+  }
+  return 0;
+}
+
+auto FontDiffEngine::checkGlyphRange(const Chunk &chunk, DiffReporter &reporter) const -> int {
+  IBMFFontDiff::Face &face1     = *chunk.face1;
+  IBMFFontDiff::Face &face2     = *chunk.face2;
+  int                 diffCount = 0;
+  int                 count     = chunk.last - chunk.first;
+
+  GlyphCode codes2[CHUNK_SIZE];
+  bool      consecutive = true;
+
+  for (int idx = 0; idx < count; idx++) {
+    codes2[idx] = font2_->translate(font1_->getUTF32(chunk.first + idx));
+    consecutive = consecutive && (codes2[idx] == codes2[0] + idx) &&
+                  (codes2[idx] < face2.metrics.size());
+  }
+
+  // First pass: when the chunk glyphs are consecutive in both faces, their metrics
+  // are compared a whole column at a time.
+  uint64_t mismatches[MetricColumnsCompare::maskSize(CHUNK_SIZE)];
+  if (consecutive) {
+    MetricColumnsCompare::metricsDiffer(face1.metrics, chunk.first, face2.metrics, codes2[0],
+                                       count, mismatches);
+  }
+
+  for (GlyphCode code1 = chunk.first; code1 < chunk.last; code1++) {
+    int       idx       = code1 - chunk.first;
+    char32_t  codePoint = font1_->getUTF32(code1);
+    GlyphCode code2     = codes2[idx];
+    if ((code2 != NO_GLYPH_CODE) && (code2 != SPACE_CODE) && (code2 < face2.header->glyphCount)) {
+      if (face1.glyphHashes[code1] == face2.glyphHashes[code2]) continue;
+
+      bool metricsDiffer = consecutive ? ((mismatches[idx >> 6] >> (idx & 63)) & 1) != 0
+                                       : !(face1.glyphs[code1] == face2.glyphs[code2]);
+
+      DiffReporter::GlyphRef glyph1{*font1_, face1, code1};
+      DiffReporter::GlyphRef glyph2{*font2_, face2, code2};
+      if (metricsDiffer) {
+        reporter.glyphMetricsDiffer(codePoint, glyph1, glyph2);
+        diffCount += 1;
+      }
+      if (!face1.sameBitmap(code1, face2, code2)) {
+        reporter.glyphPixelsDiffer(codePoint, glyph1, glyph2);
+        diffCount += 1;
+      }
+      if (!options_.ligKernPairs &&
+          !(face1.glyphsLigKern[code1] == face2.glyphsLigKern[code2])) {
+        reporter.glyphLigKernDiffer(codePoint, glyph1, glyph2);
+        diffCount += 1;
+      }
+    } else {
+      reporter.codePointNotFound('>', face1.header->pointSize, codePoint);
+      diffCount += 1;
+    }
+  }
+
+  return diffCount;
+}
+
+auto FontDiffEngine::checkMissingRange(const Chunk &chunk, DiffReporter &reporter) const -> int {
+  int diffCount = 0;
+
+  for (GlyphCode code2 = chunk.first; code2 < chunk.last; code2++) {
+    char32_t  codePoint = font2_->getUTF32(code2);
+    GlyphCode code1     = font1_->translate(codePoint);
+    if ((code1 == NO_GLYPH_CODE) || (code1 == SPACE_CODE)) {
+      reporter.codePointNotFound('<', chunk.face1->header->pointSize, codePoint);
+      diffCount += 1;
+    }
+  }
+
+  return diffCount;
+}
+
+auto FontDiffEngine::checkLigKernPairs(const Chunk &chunk, DiffReporter &reporter) const -> int {
+  IBMFFontDiff::LigKernPairs pairs1    = font1_->getLigKernPairs(*chunk.face1);
+  IBMFFontDiff::LigKernPairs pairs2    = font2_->getLigKernPairs(*chunk.face2);
+  uint8_t                    pointSize = chunk.face1->header->pointSize;
+  int                        diffCount = 0;
+
+  auto pair1 = pairs1.begin();
+  auto pair2 = pairs2.begin();
+
+  while ((pair1 != pairs1.end()) || (pair2 != pairs2.end())) {
+    if ((pair2 == pairs2.end()) || ((pair1 != pairs1.end()) && pair1->keyLess(*pair2))) {
+      reporter.ligKernPairDiffer(pointSize, &*pair1, nullptr);
+      diffCount += 1;
+      pair1++;
+    } else if ((pair1 == pairs1.end()) || pair2->keyLess(*pair1)) {
+      reporter.ligKernPairDiffer(pointSize, nullptr, &*pair2);
+      diffCount += 1;
+      pair2++;
+    } else {
+      if (pair1->value != pair2->value) {
+        reporter.ligKernPairDiffer(pointSize, &*pair1, &*pair2);
+        diffCount += 1;
+      }
+      pair1++;
+      pair2++;
+    }
+  }
+
+  return diffCount;
+}
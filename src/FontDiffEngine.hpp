@@ -0,0 +1,78 @@
+#pragma once
+
+#include "DiffReporter.hpp"
+#include "IBMFFontDiff.hpp"
+#include "ThreadPool.hpp"
+
+struct DiffOptions {
+  bool ligKernPairs = false; // Compare the lig/kern pairs of whole faces
+  bool streaming    = false; // Load the fonts in streaming mode, see IBMFFontDiff
+};
+
+/**
+ * @brief Comparison of two IBMF fonts.
+ *
+ * The faces of both fonts are matched through their point size. Faces and glyphs
+ * with the same content hash are not compared any further. The glyphs of
+ * each pair of faces are split in chunks of consecutive glyph codes that are
+ * compared as independent tasks of a work stealing thread pool. Every task
+ * reports its differences in a private buffer: the buffers are merged in the
+ * order of the faces and glyph codes, such that the output is the same as for
+ * a sequential comparison. The chunks are processed in windows of a few chunks
+ * per thread, their buffers being released as soon as the window is merged.
+ * The metrics of a chunk are compared in bulk, through the faces metric columns,
+ * before the glyphs are checked one at a time.
+ *
+ * When one of the fonts is loaded in streaming mode, the faces are prepared,
+ * compared and released one pair at a time.
+ *
+ * With the ligKernPairs option, the ligature/kerning steps are not compared
+ * glyph by glyph: the pairs of each face are compared as sets, through a merge
+ * of their sorted lists, and reported as added, removed or changed pairs.
+ *
+ */
+class FontDiffEngine {
+public:
+  static constexpr int CHUNK_SIZE        = 256; // Glyphs compared by a single task
+  static constexpr int CHUNKS_PER_THREAD = 4;   // Chunks of a window, for each thread
+
+  FontDiffEngine(IBMFFontDiffPtr font1, IBMFFontDiffPtr font2, ThreadPool &pool,
+                 DiffOptions options = DiffOptions())
+      : font1_(font1), font2_(font2), pool_(pool), options_(options), diffCount_(0) {}
+
+  // Compares both fonts, sending the differences to reporter. Returns the number
+  // of differences found.
+  auto run(DiffReporter &reporter) -> int;
+
+  inline auto getDiffCount() const -> int { return diffCount_; }
+
+private:
+  enum class ChunkKind : uint8_t {
+    GLYPHS,        // Glyphs of face1 compared with face2
+    MISSING,       // Glyphs of face2 checked to be present in face1
+    LIG_KERN_PAIRS // Lig/kern pairs of the faces (first and last are not used)
+  };
+
+  // A range of glyph codes to compare.
+  struct Chunk {
+    IBMFFontDiff::FacePtr face1, face2;
+    GlyphCode             first, last;
+    ChunkKind             kind;
+  };
+
+  IBMFFontDiffPtr font1_, font2_;
+  ThreadPool     &pool_;
+  DiffOptions     options_;
+  int             diffCount_;
+
+  auto checkPreamble(DiffReporter &reporter) -> void;
+  auto checkFaceHeaders(DiffReporter &reporter) -> void;
+  auto checkGlyphs(DiffReporter &reporter) -> void;
+  auto addFaceChunks(IBMFFontDiff::FacePtr face1, IBMFFontDiff::FacePtr face2,
+                     std::vector<Chunk> &chunks) const -> void;
+  auto runChunks(const std::vector<Chunk> &chunks, DiffReporter &reporter) -> void;
+  auto checkGlyphRange(const Chunk &chunk, DiffReporter &reporter) const -> int;
+  auto checkMissingRange(const Chunk &chunk, DiffReporter &reporter) const -> int;
+  auto checkLigKernPairs(const Chunk &chunk, DiffReporter &reporter) const -> int;
+  auto checkChunk(const Chunk &chunk, DiffReporter &reporter) const -> int;
+};
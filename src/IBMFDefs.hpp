@@ -4,6 +4,8 @@
 #include <memory>
 #include <vector>
 
+#include "PixelsCompare.hpp"
+
 // clang-format off
 //
 // The following definitions are used by all parts of the driver.
@@ -188,6 +190,36 @@ struct Pos {
   auto operator==(const Pos &other) const -> bool { return (x == other.x) && (y == other.y); }
 };
 
+// Read-only view of a contiguous array owned elsewhere: the font memory or a
+// face arena. Views are cheap to copy and are handed out in place of owning
+// pointers.
+
+template <typename T> class ArrayView {
+public:
+  ArrayView() : data_(nullptr), size_(0) {}
+  ArrayView(const T *data, size_t size) : data_(data), size_(size) {}
+  ArrayView(const std::vector<T> &vector) : data_(vector.data()), size_(vector.size()) {}
+
+  inline auto operator[](size_t idx) const -> const T & { return data_[idx]; }
+  inline auto data() const -> const T * { return data_; }
+  inline auto size() const -> size_t { return size_; }
+  inline auto empty() const -> bool { return size_ == 0; }
+  inline auto begin() const -> const T * { return data_; }
+  inline auto end() const -> const T * { return data_ + size_; }
+
+  auto operator==(const ArrayView &other) const -> bool {
+    if (size_ != other.size_) return false;
+    for (size_t idx = 0; idx < size_; idx++) {
+      if (!(data_[idx] == other.data_[idx])) return false;
+    }
+    return true;
+  }
+
+private:
+  const T *data_;
+  size_t   size_;
+};
+
 typedef uint8_t              *MemoryPtr;
 typedef std::vector<uint8_t>  Pixels;
 typedef Pixels               *PixelsPtr;
@@ -200,43 +232,80 @@ const constexpr GlyphCode SPACE_CODE    = 0x7FFE;
 // RLE (Run Length Encoded) Bitmap. To get something to show, they have
 // to be processed through the RLEExtractor class.
 // Dim contains the expected width and height once the bitmap has been
-// decompressed. The length is the pixels array size in bytes.
+// decompressed. The length is the pixels array size in bytes. The pixels
+// are not owned: they point inside the font memory.
 
 struct RLEBitmap {
-  Pixels   pixels;
-  Dim      dim;
-  uint16_t length;
-  void     clear() {
-        pixels.clear();
-        dim    = Dim(0, 0);
-        length = 0;
+  const uint8_t *pixels;
+  Dim            dim;
+  uint16_t       length;
+  RLEBitmap() { clear(); }
+  void clear() {
+    pixels = nullptr;
+    dim    = Dim(0, 0);
+    length = 0;
   }
 };
 typedef std::shared_ptr<RLEBitmap> RLEBitmapPtr;
 
-// Uncompressed Bitmap.
+// Uncompressed Bitmap. The pixel resolution is a template parameter so that
+// both formats can be used in the same application. With ONE_BIT, each row is
+// padded to a whole number of bytes. Bitmap is using the default resolution.
 
-struct Bitmap {
+template <PixelResolution RESOLUTION> struct BasicBitmap {
   Pixels pixels;
   Dim    dim;
-  Bitmap() { clear(); }
+  BasicBitmap() { clear(); }
   auto clear() -> void {
     pixels.clear();
     dim = Dim(0, 0);
   }
-  Bitmap(Pixels &thePixels, Dim &theDim) {
+  BasicBitmap(Pixels &thePixels, Dim &theDim) {
     pixels = thePixels;
     dim    = theDim;
   }
-  auto operator==(const Bitmap &other) const -> bool {
+  static auto rowSize(uint8_t width) -> uint32_t {
+    if constexpr (RESOLUTION == PixelResolution::ONE_BIT) {
+      return (width + 7) >> 3;
+    } else {
+      return width;
+    }
+  }
+  // Sets the dimensions and clears all pixels
+  auto resize(Dim theDim) -> void {
+    dim    = theDim;
+    pixels = Pixels(rowSize(dim.width) * dim.height, 0);
+  }
+  auto operator==(const BasicBitmap &other) const -> bool {
     if ((pixels.size() != other.pixels.size()) || !(dim == other.dim)) return false;
-    for (int idx = 0; idx < pixels.size(); idx++) {
-      if (pixels.at(idx) != other.pixels.at(idx)) return false;
+    return PixelsCompare::equal(pixels.data(), other.pixels.data(), pixels.size());
+  }
+  // Returns the number of pixels that differ between both bitmaps, or -1 if their
+  // dimensions are not the same. If mask is not nullptr, it receives the XOR of both
+  // bitmaps pixels: a set pixel is a changed pixel.
+  auto difference(const BasicBitmap &other, Pixels *mask = nullptr) const -> int {
+    if ((pixels.size() != other.pixels.size()) || !(dim == other.dim)) return -1;
+    uint8_t *maskData = nullptr;
+    if (mask != nullptr) {
+      mask->resize(pixels.size());
+      maskData = mask->data();
+    }
+    if constexpr (RESOLUTION == PixelResolution::ONE_BIT) {
+      return PixelsCompare::xorCountBits(pixels.data(), other.pixels.data(), pixels.size(),
+                                         maskData);
+    } else {
+      return PixelsCompare::xorCountBytes(pixels.data(), other.pixels.data(), pixels.size(),
+                                          maskData);
     }
-    return true;
   }
 };
-typedef std::shared_ptr<Bitmap> BitmapPtr;
+
+typedef BasicBitmap<resolution>                  Bitmap;
+typedef BasicBitmap<PixelResolution::ONE_BIT>    OneBitBitmap;
+typedef BasicBitmap<PixelResolution::EIGHT_BITS> EightBitsBitmap;
+
+typedef std::shared_ptr<Bitmap>       BitmapPtr;
+typedef std::shared_ptr<OneBitBitmap> OneBitBitmapPtr;
 
 #pragma pack(push, 1)
 
@@ -265,7 +334,7 @@ struct FaceHeader {
   uint16_t glyphCount;       // Must be the same for all face (Except for BACKUP format)
   uint16_t ligKernStepCount; // Length of the Ligature/Kerning table
   uint32_t pixelsPoolSize;   // Size of the Pixels Pool
-  auto     operator==(FaceHeader &other) const -> bool {
+  auto     operator==(const FaceHeader &other) const -> bool {
         return (pointSize == other.pointSize) && (lineHeight == other.lineHeight) &&
                (dpi == other.dpi) && (xHeight == other.xHeight) && (emSize == other.emSize) &&
                (slantCorrection == other.slantCorrection) &&
@@ -276,10 +345,10 @@ struct FaceHeader {
 };
 
 // typedef FaceHeader *FaceHeaderPtr;
-typedef std::shared_ptr<FaceHeader> FaceHeaderPtr;
-typedef uint8_t (*PixelsPoolTempPtr)[]; // Temporary pointer
+typedef std::shared_ptr<const FaceHeader> FaceHeaderPtr;
+typedef const uint8_t (*PixelsPoolTempPtr)[]; // Temporary pointer
 typedef uint32_t PixelPoolIndex;
-typedef PixelPoolIndex (*GlyphsPixelPoolIndexesTempPtr)[]; // One for each glyph
+typedef const PixelPoolIndex (*GlyphsPixelPoolIndexesTempPtr)[]; // One for each glyph
 
 // clang-format off
 //
@@ -430,7 +499,7 @@ struct GlyphInfo {
   }
 };
 
-typedef std::shared_ptr<GlyphInfo> GlyphInfoPtr;
+typedef std::shared_ptr<const GlyphInfo> GlyphInfoPtr;
 
 struct BackupGlyphInfo {
   uint8_t    bitmapWidth;      // Width of bitmap once decompressed
@@ -454,7 +523,7 @@ struct BackupGlyphInfo {
   }
 };
 
-typedef std::shared_ptr<BackupGlyphInfo> BackupGlyphInfoPtr;
+typedef std::shared_ptr<const BackupGlyphInfo> BackupGlyphInfoPtr;
 
 // clang-format off
 // 
@@ -489,8 +558,8 @@ struct CodePointBundle {
 };
 
 typedef Plane Planes[4];
-typedef CodePointBundle (*CodePointBundlesPtr)[];
-typedef Plane (*PlanesPtr)[];
+typedef const CodePointBundle (*CodePointBundlesPtr)[];
+typedef const Plane (*PlanesPtr)[];
 
 #pragma pack(pop)
 
@@ -569,6 +638,21 @@ struct GlyphLigKern {
 };
 typedef std::shared_ptr<GlyphLigKern> GlyphLigKernPtr;
 
+// The ligature/kerning steps of a glyph, as stored in the face arenas.
+struct GlyphLigKernView {
+  ArrayView<GlyphLigStep>  ligSteps;
+  ArrayView<GlyphKernStep> kernSteps;
+  GlyphLigKernView() {}
+  GlyphLigKernView(ArrayView<GlyphLigStep> lig, ArrayView<GlyphKernStep> kern)
+      : ligSteps(lig), kernSteps(kern) {}
+  GlyphLigKernView(const GlyphLigKern &ligKern)
+      : ligSteps(ligKern.ligSteps), kernSteps(ligKern.kernSteps) {}
+  //
+  auto operator==(const GlyphLigKernView &other) const -> bool {
+    return (ligSteps == other.ligSteps) && (kernSteps == other.kernSteps);
+  }
+};
+
 #pragma pack(push, 1)
 struct BackupGlyphKernStep {
   char32_t nextCodePoint;
@@ -589,6 +673,12 @@ struct BackupGlyphLigKern {
 typedef std::shared_ptr<BackupGlyphLigKern> BackupGlyphLigKernPtr;
 #pragma pack(pop)
 
+// The ligature/kerning steps of a BACKUP format glyph, in font memory.
+struct BackupGlyphLigKernView {
+  ArrayView<BackupGlyphLigStep>  ligSteps;
+  ArrayView<BackupGlyphKernStep> kernSteps;
+};
+
 // Ligature table. Used to create entries in a new font defintition.
 // Of course, the three letters must be present in the resulting font to have
 // that ligature added to the font.
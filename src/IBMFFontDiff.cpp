@@ -1,32 +1,146 @@
 #include "IBMFFontDiff.hpp"
 
 #include <algorithm>
-#include <iomanip>
+#include <cstddef>
 #include <iostream>
+#include <memory>
+
+#include "ContentHash.hpp"
+
+// The records of the font are packed structures, read in place. The uint32_t face offsets
+// and pixel pool indexes are not, and are copied out: a BACKUP format face follows the
+// lig/kern steps of the previous one, of 6 bytes for a kerning step, and is not aligned.
+static inline auto readUInt32(const uint8_t *bytes, uint32_t index) -> uint32_t {
+  uint32_t value;
+  memcpy(&value, bytes + (sizeof(uint32_t) * index), sizeof(uint32_t));
+  return value;
+}
 
 void IBMFFontDiff::clear() {
   initialized_ = false;
   for (auto &face : faces_) {
-    for (auto bitmap : face->bitmaps) {
-      bitmap->clear();
-    }
-    for (auto bitmap : face->compressedBitmaps) {
-      bitmap->clear();
-    }
-    face->glyphs.clear();
-    face->backupGlyphs.clear();
-    face->bitmaps.clear();
-    face->compressedBitmaps.clear();
-    face->glyphsLigKern.clear();
-    face->ligKernSteps.clear();
+    face->release();
   }
   faces_.clear();
   faceOffsets_.clear();
-  planes_.clear();
-  codePointBundles_.clear();
+  planes_           = nullptr;
+  codePointBundles_ = nullptr;
+  bundlesFirstGlyphCode_.clear();
+  glyphCodePoints_.clear();
+  mappedGlyphCount_ = 0;
+}
+
+// The vectors are replaced, not cleared, for their memory to be freed.
+auto IBMFFontDiff::Face::release() -> void {
+  for (auto bitmap : bitmaps) {
+    if (bitmap != nullptr) bitmap->clear();
+  }
+  glyphs              = ArrayView<GlyphInfo>();
+  backupGlyphs        = ArrayView<BackupGlyphInfo>();
+  metrics             = MetricColumns();
+  ligKernIndex        = LigKernIndex();
+  ligKernProgram      = LigKernProgram();
+  bitmaps             = std::vector<BitmapPtr>();
+  compressedBitmaps   = std::vector<RLEBitmap>();
+  glyphsLigKern       = std::vector<GlyphLigKernView>();
+  backupGlyphsLigKern = std::vector<BackupGlyphLigKernView>();
+  ligKernSteps        = nullptr;
+  loaded              = false;
+}
+
+// Checks the extents of every section of the font against its length, in a single pass
+// over the headers and glyph tables. The font is read by load() and loadFace() without
+// any further bound check: every offset and count they use is validated here.
+auto IBMFFontDiff::validate() const -> bool {
+  uint64_t length = memoryLength_;
+
+  if (length < sizeof(Preamble)) return false;
+  const Preamble &preamble = *reinterpret_cast<const Preamble *>(memory_);
+  bool            backup   = preamble.bits.fontFormat == FontFormat::BACKUP;
+
+  uint64_t idx = ((sizeof(Preamble) + preamble.faceCount + 3) & 0xFFFFFFFC);
+  if ((idx + (sizeof(uint32_t) * preamble.faceCount)) > length) return false;
+  const uint8_t *faceOffsets = &memory_[idx];
+  idx += sizeof(uint32_t) * preamble.faceCount;
+
+  // Number of glyphCodes reached by the codePoint bundles
+  uint32_t mappedGlyphCount = 0;
+
+  if (preamble.bits.fontFormat == FontFormat::UTF32) {
+    if ((idx + sizeof(Planes)) > length) return false;
+    const Plane *planes = reinterpret_cast<const Plane *>(&memory_[idx]);
+    idx += sizeof(Planes);
+
+    uint32_t bundleCount = planes[3].codePointBundlesIdx + planes[3].entriesCount;
+    if ((idx + (sizeof(CodePointBundle) * bundleCount)) > length) return false;
+    const CodePointBundle *bundles = reinterpret_cast<const CodePointBundle *>(&memory_[idx]);
+    idx += sizeof(CodePointBundle) * bundleCount;
+
+    for (int planeIdx = 0; planeIdx < 4; planeIdx++) {
+      uint32_t first = planes[planeIdx].codePointBundlesIdx;
+      uint32_t last  = first + planes[planeIdx].entriesCount;
+      uint32_t gCode = planes[planeIdx].firstGlyphCode;
+      if (last > bundleCount) return false;
+      for (uint32_t bundleIdx = first; bundleIdx < last; bundleIdx++) {
+        if (bundles[bundleIdx].lastCodePoint < bundles[bundleIdx].firstCodePoint) return false;
+        gCode += bundles[bundleIdx].lastCodePoint - bundles[bundleIdx].firstCodePoint + 1;
+        if (gCode > 0x10000) return false;
+      }
+      mappedGlyphCount = std::max(mappedGlyphCount, gCode);
+    }
+  }
+
+  for (int i = 0; i < preamble.faceCount; i++) {
+    if (readUInt32(faceOffsets, i) != idx) return false;
+
+    if ((idx + sizeof(FaceHeader)) > length) return false;
+    const FaceHeader &header = *reinterpret_cast<const FaceHeader *>(&memory_[idx]);
+    idx += sizeof(FaceHeader);
+
+    // Every glyphCode retrieved through a codePoint must be in the face
+    if (mappedGlyphCount > header.glyphCount) return false;
+
+    uint64_t glyphInfoSize = backup ? sizeof(BackupGlyphInfo) : sizeof(GlyphInfo);
+    uint64_t glyphsSize    = (sizeof(PixelPoolIndex) + glyphInfoSize) * header.glyphCount;
+    if ((idx + glyphsSize + header.pixelsPoolSize) > length) return false;
+
+    const uint8_t *poolIndexes = &memory_[idx];
+    idx += sizeof(PixelPoolIndex) * header.glyphCount;
+    const uint8_t *glyphs = &memory_[idx];
+    idx += glyphInfoSize * header.glyphCount;
+
+    // RLE packets in the pixels pool, and size of the BACKUP format lig/kern steps
+    uint64_t ligKernSize = 0;
+    for (int glyphCode = 0; glyphCode < header.glyphCount; glyphCode++) {
+      uint64_t packetLength;
+      if (backup) {
+        const BackupGlyphInfo &glyph =
+            reinterpret_cast<const BackupGlyphInfo *>(glyphs)[glyphCode];
+        if ((glyph.ligCount < 0) || (glyph.kernCount < 0)) return false;
+        packetLength = glyph.packetLength;
+        ligKernSize += (sizeof(BackupGlyphLigStep) * glyph.ligCount) +
+                       (sizeof(BackupGlyphKernStep) * glyph.kernCount);
+      } else {
+        packetLength = reinterpret_cast<const GlyphInfo *>(glyphs)[glyphCode].packetLength;
+      }
+      if ((uint64_t(readUInt32(poolIndexes, glyphCode)) + packetLength) >
+          header.pixelsPoolSize) {
+        return false;
+      }
+    }
+    idx += header.pixelsPoolSize;
+
+    if (!backup) ligKernSize = sizeof(LigKernStep) * header.ligKernStepCount;
+    if ((idx + ligKernSize) > length) return false;
+    idx += ligKernSize;
+  }
+
+  return true;
 }
 
-bool IBMFFontDiff::load() {
+bool IBMFFontDiff::load(bool withHashes) {
+  if (!validate()) return false;
+
   // Preamble retrieval
   memcpy(&preamble_, memory_, sizeof(Preamble));
   if (strncmp("IBMF", preamble_.marker, 4) != 0) return false;
@@ -36,197 +150,172 @@ bool IBMFFontDiff::load() {
 
   // Faces offset retrieval
   for (int i = 0; i < preamble_.faceCount; i++) {
-    uint32_t offset = *((uint32_t *)&memory_[idx]);
-    faceOffsets_.push_back(offset);
+    faceOffsets_.push_back(readUInt32(&memory_[idx], 0));
     idx += 4;
   }
 
   // Unicode CodePoint Table retrieval
   if (preamble_.bits.fontFormat == FontFormat::UTF32) {
-    PlanesPtr planes      = reinterpret_cast<PlanesPtr>(&memory_[idx]);
-    int       bundleCount = 0;
-    for (int i = 0; i < 4; i++) {
-      planes_.push_back((*planes)[i]);
-      bundleCount += (*planes)[i].entriesCount;
-    }
+    planes_ = reinterpret_cast<const Plane *>(&memory_[idx]);
     idx += sizeof(Planes);
 
-    CodePointBundlesPtr codePointBundles = reinterpret_cast<CodePointBundlesPtr>(&memory_[idx]);
-    for (int i = 0; i < bundleCount; i++) {
-      codePointBundles_.push_back((*codePointBundles)[i]);
-    }
-    idx +=
-        (((*planes)[3].codePointBundlesIdx + (*planes)[3].entriesCount) * sizeof(CodePointBundle));
+    codePointBundles_ = reinterpret_cast<const CodePointBundle *>(&memory_[idx]);
+    idx += ((planes_[3].codePointBundlesIdx + planes_[3].entriesCount) * sizeof(CodePointBundle));
+
+    prepareCodePointIndex();
   } else {
-    planes_.clear();
-    codePointBundles_.clear();
+    planes_           = nullptr;
+    codePointBundles_ = nullptr;
   }
 
   // Faces retrieval
   for (int i = 0; i < preamble_.faceCount; i++) {
-    if (idx != faceOffsets_[i]) return false;
+    FacePtr face = FacePtr(new Face);
+    face->header = FaceHeaderPtr(memoryOwner_, reinterpret_cast<const FaceHeader *>(&memory_[idx]));
+    face->offset = idx;
 
-    // Face Header
-    FacePtr                       face   = FacePtr(new Face);
-    FaceHeaderPtr                 header = FaceHeaderPtr(new FaceHeader);
-    GlyphsPixelPoolIndexesTempPtr glyphsPixelPoolIndexes;
-    PixelsPoolTempPtr             pixelsPool;
+    if (!loadFace(*face)) return false;
+    if (withHashes) computeFaceHashes(*face);
 
-    memcpy(header.get(), &memory_[idx], sizeof(FaceHeader));
-    idx += sizeof(FaceHeader);
+    idx += face->size;
+    if (streaming_) releaseFace(*face);
 
-    // Glyphs RLE bitmaps indexes in the bitmaps pool
-    glyphsPixelPoolIndexes = reinterpret_cast<GlyphsPixelPoolIndexesTempPtr>(&memory_[idx]);
-    idx += (sizeof(PixelPoolIndex) * header->glyphCount);
+    faces_.push_back(std::move(face));
+  }
 
-    // Glyphs info and bitmaps
+  return true;
+}
 
-    if (preamble_.bits.fontFormat == FontFormat::BACKUP) {
-      pixelsPool = reinterpret_cast<PixelsPoolTempPtr>(
-          &memory_[idx + (sizeof(BackupGlyphInfo) * header->glyphCount)]);
-
-      face->backupGlyphs.reserve(header->glyphCount);
-
-      for (int glyphCode = 0; glyphCode < header->glyphCount; glyphCode++) {
-        BackupGlyphInfoPtr backupGlyphInfo = BackupGlyphInfoPtr(new BackupGlyphInfo);
-        memcpy(backupGlyphInfo.get(), &memory_[idx], sizeof(BackupGlyphInfo));
-        idx += sizeof(BackupGlyphInfo);
-
-        int       bitmap_size = backupGlyphInfo->bitmapHeight * backupGlyphInfo->bitmapWidth;
-        BitmapPtr bitmap      = BitmapPtr(new Bitmap);
-        bitmap->pixels        = Pixels(bitmap_size, 0);
-        bitmap->dim           = Dim(backupGlyphInfo->bitmapWidth, backupGlyphInfo->bitmapHeight);
-
-        RLEBitmapPtr compressedBitmap = RLEBitmapPtr(new RLEBitmap);
-        compressedBitmap->dim         = bitmap->dim;
-        compressedBitmap->pixels.reserve(backupGlyphInfo->packetLength);
-        compressedBitmap->length = backupGlyphInfo->packetLength;
-        for (int pos = 0; pos < backupGlyphInfo->packetLength; pos++) {
-          compressedBitmap->pixels.push_back(
-              (*pixelsPool)[pos + (*glyphsPixelPoolIndexes)[glyphCode]]);
-        }
-
-        RLEExtractor rle;
-        rle.retrieveBitmap(*compressedBitmap, *bitmap, Pos(0, 0), backupGlyphInfo->rleMetrics);
-        // retrieveBitmap(idx, glyphInfo.get(), *bitmap, Pos(0,0));
-
-        face->backupGlyphs.push_back(backupGlyphInfo);
-        face->bitmaps.push_back(bitmap);
-        face->compressedBitmaps.push_back(compressedBitmap);
-
-        // idx += glyphInfo->packetLength;
-      }
-    } else {
-      pixelsPool = reinterpret_cast<PixelsPoolTempPtr>(
-          &memory_[idx + (sizeof(GlyphInfo) * header->glyphCount)]);
-
-      face->glyphs.reserve(header->glyphCount);
-
-      for (int glyphCode = 0; glyphCode < header->glyphCount; glyphCode++) {
-        GlyphInfoPtr glyphInfo = GlyphInfoPtr(new GlyphInfo);
-        memcpy(glyphInfo.get(), &memory_[idx], sizeof(GlyphInfo));
-        idx += sizeof(GlyphInfo);
-
-        int       bitmap_size         = glyphInfo->bitmapHeight * glyphInfo->bitmapWidth;
-        BitmapPtr bitmap              = BitmapPtr(new Bitmap);
-        bitmap->pixels                = Pixels(bitmap_size, 0);
-        bitmap->dim                   = Dim(glyphInfo->bitmapWidth, glyphInfo->bitmapHeight);
-
-        RLEBitmapPtr compressedBitmap = RLEBitmapPtr(new RLEBitmap);
-        compressedBitmap->dim         = bitmap->dim;
-        compressedBitmap->pixels.reserve(glyphInfo->packetLength);
-        compressedBitmap->length = glyphInfo->packetLength;
-        for (int pos = 0; pos < glyphInfo->packetLength; pos++) {
-          compressedBitmap->pixels.push_back(
-              (*pixelsPool)[pos + (*glyphsPixelPoolIndexes)[glyphCode]]);
-        }
-
-        RLEExtractor rle;
-        rle.retrieveBitmap(*compressedBitmap, *bitmap, Pos(0, 0), glyphInfo->rleMetrics);
-        // retrieveBitmap(idx, glyphInfo.get(), *bitmap, Pos(0,0));
-
-        face->glyphs.push_back(glyphInfo);
-        face->bitmaps.push_back(bitmap);
-        face->compressedBitmaps.push_back(compressedBitmap);
-
-        // idx += glyphInfo->packetLength;
-      }
-    }
+// Retrieves the glyphs of a face, from its header at face.offset. On success, face.size
+// is the size of the face in the font memory.
+auto IBMFFontDiff::loadFace(Face &face) -> bool {
+  const FaceHeader             &header = *face.header;
+  uint32_t                      idx    = face.offset;
+  const uint8_t                *glyphsPixelPoolIndexes;
+  PixelsPoolTempPtr             pixelsPool;
 
-    if (&memory_[idx] != (uint8_t *)pixelsPool) {
-      return false;
+  idx += sizeof(FaceHeader);
+
+  // Glyphs RLE bitmaps indexes in the bitmaps pool
+  glyphsPixelPoolIndexes = &memory_[idx];
+  idx += (sizeof(PixelPoolIndex) * header.glyphCount);
+
+  // Glyphs info and bitmaps
+
+  if (preamble_.bits.fontFormat == FontFormat::BACKUP) {
+    pixelsPool = reinterpret_cast<PixelsPoolTempPtr>(
+        &memory_[idx + (sizeof(BackupGlyphInfo) * header.glyphCount)]);
+
+    face.backupGlyphs = ArrayView<BackupGlyphInfo>(
+        reinterpret_cast<const BackupGlyphInfo *>(&memory_[idx]), header.glyphCount);
+    idx += sizeof(BackupGlyphInfo) * header.glyphCount;
+
+    face.compressedBitmaps.resize(header.glyphCount);
+    for (int glyphCode = 0; glyphCode < header.glyphCount; glyphCode++) {
+      const BackupGlyphInfo &backupGlyphInfo  = face.backupGlyphs[glyphCode];
+      RLEBitmap             &compressedBitmap = face.compressedBitmaps[glyphCode];
+
+      compressedBitmap.dim    = Dim(backupGlyphInfo.bitmapWidth, backupGlyphInfo.bitmapHeight);
+      compressedBitmap.length = backupGlyphInfo.packetLength;
+      compressedBitmap.pixels = &(*pixelsPool)[readUInt32(glyphsPixelPoolIndexes, glyphCode)];
+    }
+  } else {
+    pixelsPool = reinterpret_cast<PixelsPoolTempPtr>(
+        &memory_[idx + (sizeof(GlyphInfo) * header.glyphCount)]);
+
+    face.glyphs = ArrayView<GlyphInfo>(reinterpret_cast<const GlyphInfo *>(&memory_[idx]),
+                                       header.glyphCount);
+    idx += sizeof(GlyphInfo) * header.glyphCount;
+    face.metrics.assign(face.glyphs);
+
+    face.compressedBitmaps.resize(header.glyphCount);
+    for (int glyphCode = 0; glyphCode < header.glyphCount; glyphCode++) {
+      const GlyphInfo &glyphInfo        = face.glyphs[glyphCode];
+      RLEBitmap       &compressedBitmap = face.compressedBitmaps[glyphCode];
+
+      compressedBitmap.dim    = Dim(glyphInfo.bitmapWidth, glyphInfo.bitmapHeight);
+      compressedBitmap.length = glyphInfo.packetLength;
+      compressedBitmap.pixels = &(*pixelsPool)[readUInt32(glyphsPixelPoolIndexes, glyphCode)];
     }
+  }
 
-    idx += header->pixelsPoolSize;
+  face.bitmaps.resize(header.glyphCount); // Filled by Face::getBitmap()
 
-    if (preamble_.bits.fontFormat == FontFormat::BACKUP) {
-      for (GlyphCode glyphCode = 0; glyphCode < header->glyphCount; glyphCode++) {
-        BackupGlyphLigKernPtr glk = BackupGlyphLigKernPtr(new BackupGlyphLigKern);
-
-        for (int i = 0; i < face->backupGlyphs[glyphCode]->ligCount; i++) {
-          BackupGlyphLigStep l;
-          memcpy(&l, &memory_[idx], sizeof(BackupGlyphLigStep));
-          idx += sizeof(BackupGlyphLigStep);
-          glk->ligSteps.push_back(l);
-        }
-        for (int i = 0; i < face->backupGlyphs[glyphCode]->kernCount; i++) {
-          BackupGlyphKernStep k;
-          memcpy(&k, &memory_[idx], sizeof(BackupGlyphKernStep));
-          idx += sizeof(BackupGlyphKernStep);
-          glk->kernSteps.push_back(k);
-        }
-        face->backupGlyphsLigKern.push_back(glk);
-      }
+  idx += header.pixelsPoolSize;
 
-      face->header = header;
-      faces_.push_back(std::move(face));
-    } else {
-      if (header->ligKernStepCount > 0) {
-        face->ligKernSteps.reserve(header->ligKernStepCount);
-        for (int j = 0; j < header->ligKernStepCount; j++) {
-          LigKernStep step;
-          memcpy(&step, &memory_[idx], sizeof(LigKernStep));
+  if (preamble_.bits.fontFormat == FontFormat::BACKUP) {
+    face.backupGlyphsLigKern.resize(header.glyphCount);
+    for (GlyphCode glyphCode = 0; glyphCode < header.glyphCount; glyphCode++) {
+      const BackupGlyphInfo  &glyph = face.backupGlyphs[glyphCode];
+      BackupGlyphLigKernView &glk   = face.backupGlyphsLigKern[glyphCode];
 
-          face->ligKernSteps.push_back(step);
+      glk.ligSteps = ArrayView<BackupGlyphLigStep>(
+          reinterpret_cast<const BackupGlyphLigStep *>(&memory_[idx]), glyph.ligCount);
+      idx += sizeof(BackupGlyphLigStep) * glyph.ligCount;
+      glk.kernSteps = ArrayView<BackupGlyphKernStep>(
+          reinterpret_cast<const BackupGlyphKernStep *>(&memory_[idx]), glyph.kernCount);
+      idx += sizeof(BackupGlyphKernStep) * glyph.kernCount;
+    }
+  } else {
+    if (header.ligKernStepCount > 0) {
+      face.ligKernSteps = reinterpret_cast<const LigKernStep *>(&memory_[idx]);
+      idx += (sizeof(LigKernStep) * header.ligKernStepCount);
+    }
 
-          idx += sizeof(LigKernStep);
-        }
-      }
+    if (!face.ligKernProgram.compile(face.ligKernSteps, header.ligKernStepCount,
+                                     header.glyphCount)) {
+      return false;
+    }
 
-      for (GlyphCode glyphCode = 0; glyphCode < header->glyphCount; glyphCode++) {
-        GlyphLigKernPtr glk = GlyphLigKernPtr(new GlyphLigKern);
-
-        if (face->glyphs[glyphCode]->ligKernPgmIndex != 255) {
-          int lk_idx = face->glyphs[glyphCode]->ligKernPgmIndex;
-          if (lk_idx < header->ligKernStepCount) {
-            if ((face->ligKernSteps[lk_idx].b.goTo.isAGoTo) &&
-                (face->ligKernSteps[lk_idx].b.kern.isAKern)) {
-              lk_idx = face->ligKernSteps[lk_idx].b.goTo.displacement;
-            }
-            do {
-              if (face->ligKernSteps[lk_idx].b.kern.isAKern) { // true = kern, false = ligature
-                glk->kernSteps.push_back(
-                    GlyphKernStep{.nextGlyphCode = face->ligKernSteps[lk_idx].a.data.nextGlyphCode,
-                                  .kern          = face->ligKernSteps[lk_idx].b.kern.kerningValue});
-              } else {
-                glk->ligSteps.push_back(GlyphLigStep{
-                    .nextGlyphCode        = face->ligKernSteps[lk_idx].a.data.nextGlyphCode,
-                    .replacementGlyphCode = face->ligKernSteps[lk_idx].b.repl.replGlyphCode});
-              }
-            } while (!face->ligKernSteps[lk_idx++].a.data.stop);
-          }
-        }
-        face->glyphsLigKern.push_back(glk);
+    face.glyphsLigKern.resize(header.glyphCount);
+    for (GlyphCode glyphCode = 0; glyphCode < header.glyphCount; glyphCode++) {
+      int pgmIndex = face.glyphs[glyphCode].ligKernPgmIndex;
+      if ((pgmIndex != 255) &&
+          !face.ligKernProgram.getGlyphLigKern(pgmIndex, face.glyphsLigKern[glyphCode])) {
+        return false;
       }
-
-      face->header = header;
-      faces_.push_back(std::move(face));
     }
+    face.ligKernIndex.build(face.glyphsLigKern);
   }
 
+  face.size   = idx - face.offset;
+  face.loaded = true;
   return true;
 }
 
+// Glyph chunks of a face are compared concurrently: the cache entries are accessed
+// atomically. Two threads may decode the same glyph, the last one is kept.
+auto IBMFFontDiff::Face::getBitmap(GlyphCode glyphCode) -> BitmapPtr {
+  BitmapPtr bitmap = std::atomic_load(&bitmaps[glyphCode]);
+
+  if (bitmap == nullptr) {
+    bitmap = BitmapPtr(new Bitmap);
+    retrieveBitmap(glyphCode, *bitmap);
+    std::atomic_store(&bitmaps[glyphCode], bitmap);
+  }
+  return bitmap;
+}
+
+auto IBMFFontDiff::Face::getRLEMetrics(GlyphCode glyphCode) const -> RLEMetrics {
+  return glyphs.empty() ? backupGlyphs[glyphCode].rleMetrics : glyphs[glyphCode].rleMetrics;
+}
+
+auto IBMFFontDiff::Face::sameBitmap(GlyphCode glyphCode, Face &other, GlyphCode otherGlyphCode)
+    -> bool {
+  const RLEBitmap &packet       = compressedBitmaps[glyphCode];
+  const RLEBitmap &otherPacket  = other.compressedBitmaps[otherGlyphCode];
+  RLEMetrics       metrics      = getRLEMetrics(glyphCode);
+  RLEMetrics       otherMetrics = other.getRLEMetrics(otherGlyphCode);
+
+  if ((packet.dim == otherPacket.dim) && (packet.length == otherPacket.length) &&
+      (metrics.dynF == otherMetrics.dynF) && (metrics.firstIsBlack == otherMetrics.firstIsBlack) &&
+      (memcmp(packet.pixels, otherPacket.pixels, packet.length) == 0)) {
+    return true;
+  }
+
+  return *getBitmap(glyphCode) == *other.getBitmap(otherGlyphCode);
+}
+
 auto IBMFFontDiff::findFace(uint8_t pointSize) -> FacePtr {
 
   for (auto &face : faces_) {
@@ -239,7 +328,7 @@ auto IBMFFontDiff::findGlyphIndex(FacePtr face, char32_t codePoint) const -> int
 
   int idx = 0;
   for (auto &glyph : face->backupGlyphs) {
-    if (glyph->codePoint == codePoint) return idx;
+    if (glyph.codePoint == codePoint) return idx;
     idx++;
   }
   return -1;
@@ -278,36 +367,39 @@ auto IBMFFontDiff::ligKern(int faceIndex, const GlyphCode glyphCode1, GlyphCode
     return false;
   }
 
-  //
-  GlyphLigSteps  *ligSteps;
-  GlyphKernSteps *kernSteps;
+  GlyphCode code = faces_[faceIndex]->glyphs[*glyphCode2].mainCode;
+  if (preamble_.bits.fontFormat == FontFormat::LATIN) {
+    code &= LATIN_GLYPH_CODE_MASK;
+  }
 
   if (bypassLigKern == nullptr) {
-    ligSteps  = &faces_[faceIndex]->glyphsLigKern[glyphCode1]->ligSteps;
-    kernSteps = &faces_[faceIndex]->glyphsLigKern[glyphCode1]->kernSteps;
-  } else {
-    ligSteps  = &bypassLigKern->ligSteps;
-    kernSteps = &bypassLigKern->kernSteps;
-  }
+    const LigKernIndex &index = faces_[faceIndex]->ligKernIndex;
+
+    if (index.findLigature(glyphCode1, *glyphCode2, *glyphCode2)) return true;
 
-  if ((ligSteps->size() == 0) && (kernSteps->size() == 0)) {
+    FIX16 k;
+    if (index.findKern(glyphCode1, code, k)) {
+      *kern            = k;
+      *kernPairPresent = true;
+    }
     return false;
   }
 
-  GlyphCode code = faces_[faceIndex]->glyphs[*glyphCode2]->mainCode;
-  if (preamble_.bits.fontFormat == FontFormat::LATIN) {
-    code &= LATIN_GLYPH_CODE_MASK;
+  //
+  GlyphLigKernView ligKern(*bypassLigKern);
+
+  if (ligKern.ligSteps.empty() && ligKern.kernSteps.empty()) {
+    return false;
   }
-  bool first = true;
 
-  for (auto &ligStep : *ligSteps) {
+  for (auto &ligStep : ligKern.ligSteps) {
     if (ligStep.nextGlyphCode == *glyphCode2) {
       *glyphCode2 = ligStep.replacementGlyphCode;
       return true;
     }
   }
 
-  for (auto &kernStep : *kernSteps) {
+  for (auto &kernStep : ligKern.kernSteps) {
     if (kernStep.nextGlyphCode == code) {
       FIX16 k = kernStep.kern;
       if (k & 0x2000) k |= 0xC000;
@@ -319,8 +411,31 @@ auto IBMFFontDiff::ligKern(int faceIndex, const GlyphCode glyphCode1, GlyphCode
   return false;
 }
 
-auto IBMFFontDiff::getGlyph(int faceIndex, int glyphCode, GlyphInfoPtr &glyphInfo,
-                            BitmapPtr &bitmap, GlyphLigKernPtr &glyphLigKern) const -> bool {
+auto IBMFFontDiff::getKerns(int faceIndex, const GlyphCode *glyphCodes, int count,
+                            FIX16 *kerns) const -> bool {
+  if ((faceIndex < 0) || (faceIndex >= preamble_.faceCount)) return false;
+
+  const Face &face       = *faces_[faceIndex];
+  int         glyphCount = face.header->glyphCount;
+
+  for (int idx = 0; idx + 1 < count; idx++) {
+    kerns[idx] = 0;
+    if ((glyphCodes[idx] >= glyphCount) || (glyphCodes[idx + 1] >= glyphCount)) continue;
+    if (!face.ligKernIndex.hasSteps(glyphCodes[idx])) continue;
+
+    GlyphCode code = face.glyphs[glyphCodes[idx + 1]].mainCode;
+    if (preamble_.bits.fontFormat == FontFormat::LATIN) {
+      code &= LATIN_GLYPH_CODE_MASK;
+    }
+    face.ligKernIndex.findKern(glyphCodes[idx], code, kerns[idx]);
+  }
+  return true;
+}
+
+// The glyph info and lig/kern steps are views, valid as long as the font is loaded.
+// The bitmap is a copy.
+auto IBMFFontDiff::getGlyph(int faceIndex, int glyphCode, const GlyphInfo *&glyphInfo,
+                            BitmapPtr &bitmap, GlyphLigKernView &glyphLigKern) const -> bool {
 
   if ((faceIndex >= preamble_.faceCount) || (glyphCode < 0) ||
       (glyphCode >= faces_[faceIndex]->header->glyphCount)) {
@@ -329,16 +444,16 @@ auto IBMFFontDiff::getGlyph(int faceIndex, int glyphCode, GlyphInfoPtr &glyphInf
 
   int glyphIndex = glyphCode;
 
-  glyphInfo      = std::make_shared<GlyphInfo>(*faces_[faceIndex]->glyphs[glyphIndex]);
-  bitmap         = std::make_shared<Bitmap>(*faces_[faceIndex]->bitmaps[glyphIndex]);
-  glyphLigKern   = std::make_shared<GlyphLigKern>(*faces_[faceIndex]->glyphsLigKern[glyphCode]);
+  glyphInfo    = &faces_[faceIndex]->glyphs[glyphIndex];
+  bitmap       = std::make_shared<Bitmap>(*faces_[faceIndex]->getBitmap(glyphIndex));
+  glyphLigKern = faces_[faceIndex]->glyphsLigKern[glyphCode];
 
   return true;
 }
 
-auto IBMFFontDiff::convertToOneBit(const Bitmap &bitmapHeightBits, BitmapPtr *bitmapOneBit)
-    -> bool {
-  *bitmapOneBit        = BitmapPtr(new Bitmap);
+auto IBMFFontDiff::convertToOneBit(const EightBitsBitmap &bitmapHeightBits,
+                                   OneBitBitmapPtr        *bitmapOneBit) -> bool {
+  *bitmapOneBit        = OneBitBitmapPtr(new OneBitBitmap);
   (*bitmapOneBit)->dim = bitmapHeightBits.dim;
   auto pix             = &(*bitmapOneBit)->pixels;
   for (int row = 0, idx = 0; row < bitmapHeightBits.dim.height; row++) {
@@ -373,34 +488,179 @@ auto IBMFFontDiff::findList(std::vector<LigKernStep> &pgm, std::vector<LigKernSt
   return (it == list.end()) ? -1 : std::distance(list.begin(), it);
 }
 
-auto IBMFFontDiff::toGlyphCode(char32_t codePoint) const -> GlyphCode {
+// Computes the glyphCode of the first codePoint of every bundle, such that a
+// codePoint can be located with a binary search over the bundles of its plane.
+// The reverse table, giving the codePoint of every glyphCode, is built at the same time.
+auto IBMFFontDiff::prepareCodePointIndex() -> void {
+  bundlesFirstGlyphCode_.resize(planes_[3].codePointBundlesIdx + planes_[3].entriesCount);
+
+  for (int planeIdx = 0; planeIdx < 4; planeIdx++) {
+    int gCode = planes_[planeIdx].firstGlyphCode;
+    int last  = planes_[planeIdx].codePointBundlesIdx + planes_[planeIdx].entriesCount;
+    for (int idx = planes_[planeIdx].codePointBundlesIdx; idx < last; idx++) {
+      int bundleSize =
+          codePointBundles_[idx].lastCodePoint - codePointBundles_[idx].firstCodePoint + 1;
+      bundlesFirstGlyphCode_[idx] = gCode;
+      if (glyphCodePoints_.size() < size_t(gCode + bundleSize)) {
+        glyphCodePoints_.resize(gCode + bundleSize, 0);
+      }
+      char32_t codePoint = codePointBundles_[idx].firstCodePoint | (planeIdx << 16);
+      for (int i = 0; i < bundleSize; i++) {
+        glyphCodePoints_[gCode + i] = codePoint + i;
+      }
+      gCode += bundleSize;
+    }
+  }
 
-  GlyphCode glyphCode = NO_GLYPH_CODE;
+  mappedGlyphCount_ = 0;
+  while ((size_t(mappedGlyphCount_) < glyphCodePoints_.size()) &&
+         (findGlyphCode(glyphCodePoints_[mappedGlyphCount_]) == mappedGlyphCount_)) {
+    mappedGlyphCount_ += 1;
+  }
+}
 
-  uint16_t planeIdx   = static_cast<uint16_t>(codePoint >> 16);
+auto IBMFFontDiff::computeFaceHashes(Face &face) const -> void {
+  ContentHash faceHash;
 
-  if (planeIdx <= 3) {
-    char16_t u16                = static_cast<char16_t>(codePoint);
+  faceHash.add(face.header.get(), sizeof(FaceHeader));
+  face.glyphHashes.resize(face.header->glyphCount);
 
-    uint16_t codePointBundleIdx = planes_[planeIdx].codePointBundlesIdx;
-    uint16_t entriesCount       = planes_[planeIdx].entriesCount;
-    int      gCode              = planes_[planeIdx].firstGlyphCode;
-    int      i                  = 0;
-    while (i < entriesCount) {
-      if (u16 <= codePointBundles_[codePointBundleIdx].lastCodePoint) {
-        break;
-      }
-      gCode += (codePointBundles_[codePointBundleIdx].lastCodePoint -
-                codePointBundles_[codePointBundleIdx].firstCodePoint + 1);
-      i++;
-      codePointBundleIdx++;
+  for (GlyphCode glyphCode = 0; glyphCode < face.header->glyphCount; glyphCode++) {
+    const RLEBitmap &packet = face.compressedBitmaps[glyphCode];
+    ContentHash      hash;
+
+    if (preamble_.bits.fontFormat == FontFormat::BACKUP) {
+      const BackupGlyphInfo        &glyph   = face.backupGlyphs[glyphCode];
+      const BackupGlyphLigKernView &ligKern = face.backupGlyphsLigKern[glyphCode];
+
+      hash.add(&glyph, sizeof(BackupGlyphInfo));
+      hash.add(ligKern.ligSteps.data(), ligKern.ligSteps.size() * sizeof(BackupGlyphLigStep));
+      hash.add(ligKern.kernSteps.data(), ligKern.kernSteps.size() * sizeof(BackupGlyphKernStep));
+    } else {
+      const GlyphInfo        &glyph   = face.glyphs[glyphCode];
+      const GlyphLigKernView &ligKern = face.glyphsLigKern[glyphCode];
+
+      hash.add(getUTF32(glyphCode));
+      hash.add(&glyph, offsetof(GlyphInfo, ligKernPgmIndex)).add(glyph.mainCode);
+      hash.add(uint16_t(ligKern.ligSteps.size())).add(uint16_t(ligKern.kernSteps.size()));
+      hash.add(ligKern.ligSteps.data(), ligKern.ligSteps.size() * sizeof(GlyphLigStep));
+      hash.add(ligKern.kernSteps.data(), ligKern.kernSteps.size() * sizeof(GlyphKernStep));
+    }
+    hash.add(packet.pixels, packet.length);
+
+    face.glyphHashes[glyphCode] = hash.get();
+    faceHash.add(face.glyphHashes[glyphCode]);
+  }
+
+  face.hash = faceHash.get();
+}
+
+auto IBMFFontDiff::computeHashes() -> void {
+  for (auto &face : faces_) {
+    bool loaded = face->loaded;
+    if (!prepareFace(*face)) continue;
+    computeFaceHashes(*face);
+    if (!loaded) releaseFace(*face);
+  }
+}
+
+auto IBMFFontDiff::prepareFace(Face &face) -> bool {
+  if (face.loaded) return true;
+  if (loadFace(face)) return true;
+
+  face.release();
+  return false;
+}
+
+auto IBMFFontDiff::releaseFace(Face &face) -> void {
+  face.release();
+  if (mappedFile_ != nullptr) mappedFile_->release(face.offset, face.size);
+}
+
+auto IBMFFontDiff::getLigKernPairs(const Face &face) const -> LigKernPairs {
+  LigKernPairs pairs;
+
+  for (GlyphCode glyphCode = 0; glyphCode < face.glyphsLigKern.size(); glyphCode++) {
+    const GlyphLigKernView &ligKern   = face.glyphsLigKern[glyphCode];
+    char32_t                codePoint = getUTF32(glyphCode);
+
+    for (auto &lig : ligKern.ligSteps) {
+      pairs.push_back(LigKernPair{.codePoint     = codePoint,
+                                  .nextCodePoint = getUTF32(lig.nextGlyphCode),
+                                  .ligature      = true,
+                                  .value         = int32_t(getUTF32(lig.replacementGlyphCode))});
+    }
+    for (auto &kern : ligKern.kernSteps) {
+      FIX16 k = kern.kern;
+      if (k & 0x2000) k |= 0xC000;
+      pairs.push_back(LigKernPair{.codePoint     = codePoint,
+                                  .nextCodePoint = getUTF32(kern.nextGlyphCode),
+                                  .ligature      = false,
+                                  .value         = k});
     }
-    if ((i < entriesCount) && (u16 >= codePointBundles_[codePointBundleIdx].firstCodePoint)) {
-      glyphCode = gCode + u16 - codePointBundles_[codePointBundleIdx].firstCodePoint;
+  }
+
+  // The stable sort keeps the steps order of each key, the first one being retained
+  std::stable_sort(pairs.begin(), pairs.end(),
+                   [](const LigKernPair &a, const LigKernPair &b) { return a.keyLess(b); });
+  pairs.erase(std::unique(pairs.begin(), pairs.end(),
+                          [](const LigKernPair &a, const LigKernPair &b) { return a.sameKey(b); }),
+              pairs.end());
+
+  return pairs;
+}
+
+auto IBMFFontDiff::getFingerprints() const -> Fingerprints {
+  Fingerprints fingerprints;
+
+  for (auto &face : faces_) {
+    fingerprints.push_back(FaceFingerprint{.pointSize   = face->header->pointSize,
+                                           .hash        = face->hash,
+                                           .glyphHashes = face->glyphHashes});
+  }
+  return fingerprints;
+}
+
+auto IBMFFontDiff::setFingerprints(Fingerprints &&fingerprints) -> bool {
+  if (fingerprints.size() != faces_.size()) return false;
+
+  for (size_t idx = 0; idx < faces_.size(); idx++) {
+    if ((fingerprints[idx].pointSize != faces_[idx]->header->pointSize) ||
+        (fingerprints[idx].glyphHashes.size() != faces_[idx]->header->glyphCount)) {
+      return false;
     }
   }
 
-  return glyphCode;
+  for (size_t idx = 0; idx < faces_.size(); idx++) {
+    faces_[idx]->hash        = fingerprints[idx].hash;
+    faces_[idx]->glyphHashes = std::move(fingerprints[idx].glyphHashes);
+  }
+  return true;
+}
+
+// Binary search of the codePoint in the sorted bundles of its plane.
+auto IBMFFontDiff::findGlyphCode(char32_t codePoint) const -> GlyphCode {
+  uint16_t planeIdx = static_cast<uint16_t>(codePoint >> 16);
+
+  if ((planes_ == nullptr) || (planeIdx > 3)) return NO_GLYPH_CODE;
+
+  char16_t               u16   = static_cast<char16_t>(codePoint);
+  const CodePointBundle *first = &codePointBundles_[planes_[planeIdx].codePointBundlesIdx];
+  const CodePointBundle *last  = first + planes_[planeIdx].entriesCount;
+
+  const CodePointBundle *bundle =
+      std::lower_bound(first, last, u16, [](const CodePointBundle &b, char16_t u) {
+        return b.lastCodePoint < u;
+      });
+
+  if ((bundle != last) && (u16 >= bundle->firstCodePoint)) {
+    return bundlesFirstGlyphCode_[bundle - codePointBundles_] + u16 - bundle->firstCodePoint;
+  }
+  return NO_GLYPH_CODE;
+}
+
+auto IBMFFontDiff::toGlyphCode(char32_t codePoint) const -> GlyphCode {
+  return findGlyphCode(codePoint);
 }
 
 /**
@@ -513,28 +773,8 @@ auto IBMFFontDiff::translate(char32_t codePoint) const -> GlyphCode {
       }
     }
   } else if (preamble_.bits.fontFormat == FontFormat::UTF32) {
-    uint16_t planeIdx = static_cast<uint16_t>(codePoint >> 16);
-
-    if (planeIdx <= 3) {
-      char16_t u16                = static_cast<char16_t>(codePoint);
-
-      uint16_t codePointBundleIdx = planes_[planeIdx].codePointBundlesIdx;
-      uint16_t entriesCount       = planes_[planeIdx].entriesCount;
-      int      gCode              = planes_[planeIdx].firstGlyphCode;
-      int      i                  = 0;
-      while (i < entriesCount) {
-        if (u16 <= codePointBundles_[codePointBundleIdx].lastCodePoint) {
-          break;
-        }
-        gCode += (codePointBundles_[codePointBundleIdx].lastCodePoint -
-                  codePointBundles_[codePointBundleIdx].firstCodePoint + 1);
-        i++;
-        codePointBundleIdx++;
-      }
-      if ((i < entriesCount) && (u16 >= codePointBundles_[codePointBundleIdx].firstCodePoint)) {
-        glyphCode = gCode + u16 - codePointBundles_[codePointBundleIdx].firstCodePoint;
-      }
-    }
+    GlyphCode code = findGlyphCode(codePoint);
+    if (code != NO_GLYPH_CODE) glyphCode = code;
   }
 
   return glyphCode;
@@ -542,43 +782,14 @@ auto IBMFFontDiff::translate(char32_t codePoint) const -> GlyphCode {
 
 // Returns the corresponding UTF32 character for the glyphCode.
 auto IBMFFontDiff::getUTF32(GlyphCode glyphCode) const -> char32_t {
-  char32_t codePoint = 0;
   if (preamble_.bits.fontFormat == FontFormat::UTF32) {
-    int i = 0;
-    while (i < 3) {
-      if (planes_[i + 1].firstGlyphCode > glyphCode) break;
-      i += 1;
-    }
-    if (i < 4) {
-      int planeMask    = i << 16;
-      int bundleIdx    = planes_[i].codePointBundlesIdx;
-      int idx          = planes_[i].firstGlyphCode;
-      int entriesCount = planes_[i].entriesCount;
-      int j            = 0;
-      int bundleSize   = codePointBundles_[bundleIdx].lastCodePoint -
-                       codePointBundles_[bundleIdx].firstCodePoint + 1;
-
-      while (j < entriesCount) {
-        if ((idx + bundleSize) > glyphCode) break;
-        idx += bundleSize;
-        bundleIdx += 1;
-        bundleSize = codePointBundles_[bundleIdx].lastCodePoint -
-                     codePointBundles_[bundleIdx].firstCodePoint + 1;
-        j += 1;
-      }
-      if (j < entriesCount) {
-        codePoint = (codePointBundles_[bundleIdx].firstCodePoint + (glyphCode - idx)) | planeMask;
-      }
-    }
+    return (glyphCode < glyphCodePoints_.size()) ? glyphCodePoints_[glyphCode] : 0;
   } else {
-    if (glyphCode < fontFormat0CodePoints.size()) {
-      codePoint = fontFormat0CodePoints[glyphCode];
-    }
+    return (glyphCode < fontFormat0CodePoints.size()) ? fontFormat0CodePoints[glyphCode] : 0;
   }
-  return codePoint;
 }
 
-auto IBMFFontDiff::showBitmap(std::ostream &stream, char first, const BitmapPtr bitmap) const
+auto IBMFFontDiff::showBitmap(ReportWriter &writer, char first, const BitmapPtr bitmap) const
     -> void {
 
   uint32_t  row, col;
@@ -589,120 +800,108 @@ auto IBMFFontDiff::showBitmap(std::ostream &stream, char first, const BitmapPtr
     maxWidth = bitmap->dim.width;
   }
 
-  stream << first << " "
-         << "+";
-  for (col = 0; col < maxWidth; col++) {
-    stream << '-';
-  }
-  stream << '+' << std::endl;
+  writer.put(first).put(" +").fill('-', maxWidth).put('+').endl();
 
   uint32_t rowSize = bitmap->dim.width;
   for (row = 0, rowPtr = bitmap->pixels.data(); row < bitmap->dim.height;
        row++, rowPtr += rowSize) {
-    stream << first << " "
-           << "|";
+    writer.put(first).put(" |");
     for (col = 0; col < maxWidth; col++) {
       if constexpr (BLACK_EIGHT_BITS) {
-        stream << ((rowPtr[col] == BLACK_EIGHT_BITS) ? 'X' : ' ');
+        writer.put((rowPtr[col] == BLACK_EIGHT_BITS) ? 'X' : ' ');
       } else {
-        stream << ((rowPtr[col] == BLACK_EIGHT_BITS) ? ' ' : 'X');
+        writer.put((rowPtr[col] == BLACK_EIGHT_BITS) ? ' ' : 'X');
       }
     }
-    stream << '|';
-    stream << std::endl;
+    writer.put('|').endl();
   }
 
-  stream << first << " "
-         << "+";
-  for (col = 0; col < maxWidth; col++) {
-    stream << '-';
-  }
-  stream << '+' << std::endl;
+  writer.put(first).put(" +").fill('-', maxWidth).put('+').endl();
 }
 
-#define CODEPOINT(c) "U+" << std::hex << std::setw(5) << std::setfill('0') << +(c) << std::dec
-
-auto IBMFFontDiff::showGlyphInfo(std::ostream &stream, char first, GlyphCode i,
-                                 const GlyphInfoPtr g) const -> void {
-  stream << first << " "
-         << "[" << i << "]: "
-         << "codePoint: " << CODEPOINT(+getUTF32(i)) << ", pixWdth: " << +g->bitmapWidth
-         << ", pixHght: " << +g->bitmapHeight << ", hOff: " << +g->horizontalOffset
-         << ", vOff: " << +g->verticalOffset << ", pixSiz: " << +g->packetLength
-         << ", adv: " << +((float)g->advance / 64.0) << ", dynF: " << +g->rleMetrics.dynF
-         << ", 1stBlack: " << +g->rleMetrics.firstIsBlack
-         << ", beforeOptKrn: " << +g->rleMetrics.beforeAddedOptKern
-         << ", afterOptKrn: " << +g->rleMetrics.afterAddedOptKern
-         << ", ligKrnPgmIdx: " << +g->ligKernPgmIndex;
-
-  if (g->mainCode != i) {
-    stream << ", mainCode: " << +g->mainCode << "(" << CODEPOINT(getUTF32(g->mainCode)) << ")";
+auto IBMFFontDiff::showGlyphInfo(ReportWriter &writer, char first, GlyphCode i,
+                                 const GlyphInfo &g) const -> void {
+  writer.put(first).put(" [").putInt(i).put("]: codePoint: ").putCodePoint(getUTF32(i));
+  writer.put(", pixWdth: ").putInt(g.bitmapWidth);
+  writer.put(", pixHght: ").putInt(g.bitmapHeight);
+  writer.put(", hOff: ").putInt(g.horizontalOffset);
+  writer.put(", vOff: ").putInt(g.verticalOffset);
+  writer.put(", pixSiz: ").putInt(g.packetLength);
+  writer.put(", adv: ").putFixed(g.advance);
+  writer.put(", dynF: ").putInt(g.rleMetrics.dynF);
+  writer.put(", 1stBlack: ").putInt(g.rleMetrics.firstIsBlack);
+  writer.put(", beforeOptKrn: ").putInt(g.rleMetrics.beforeAddedOptKern);
+  writer.put(", afterOptKrn: ").putInt(g.rleMetrics.afterAddedOptKern);
+  writer.put(", ligKrnPgmIdx: ").putInt(g.ligKernPgmIndex);
+
+  if (g.mainCode != i) {
+    writer.put(", mainCode: ").putInt(g.mainCode);
+    writer.put('(').putCodePoint(getUTF32(g.mainCode)).put(')');
   }
-  stream << std::endl;
+  writer.endl();
 }
 
-auto IBMFFontDiff::showLigKerns(std::ostream &stream, char first, GlyphLigKernPtr lk) const
+auto IBMFFontDiff::showLigKerns(ReportWriter &writer, char first, const GlyphLigKernView &lk) const
     -> void {
 
-  if ((lk != nullptr) && ((lk->ligSteps.size() > 0) || (lk->kernSteps.size() > 0))) {
+  if (!lk.ligSteps.empty() || !lk.kernSteps.empty()) {
     uint16_t i = 0;
-    for (auto &lig : lk->ligSteps) {
-      stream << first << " "
-             << "[" << i << "]: "
-             << "NxtGlyphCode: " << +lig.nextGlyphCode << "("
-             << CODEPOINT(getUTF32(lig.nextGlyphCode)) << "), "
-             << "LigCode: " << +lig.replacementGlyphCode << "("
-             << CODEPOINT(getUTF32(lig.replacementGlyphCode)) << ")" << std::endl;
+    for (auto &lig : lk.ligSteps) {
+      writer.put(first).put(" [").putInt(i).put("]: ");
+      writer.put("NxtGlyphCode: ").putInt(lig.nextGlyphCode);
+      writer.put('(').putCodePoint(getUTF32(lig.nextGlyphCode)).put("), ");
+      writer.put("LigCode: ").putInt(lig.replacementGlyphCode);
+      writer.put('(').putCodePoint(getUTF32(lig.replacementGlyphCode)).put(')').endl();
       i += 1;
     }
 
-    for (auto &kern : lk->kernSteps) {
-      stream << first << " "
-             << "[" << i << "]: "
-             << "NxtGlyphCode: " << +kern.nextGlyphCode << "("
-             << CODEPOINT(getUTF32(kern.nextGlyphCode)) << "), "
-             << "Kern: " << (float)(kern.kern / 64.0) << std::endl;
+    for (auto &kern : lk.kernSteps) {
+      writer.put(first).put(" [").putInt(i).put("]: ");
+      writer.put("NxtGlyphCode: ").putInt(kern.nextGlyphCode);
+      writer.put('(').putCodePoint(getUTF32(kern.nextGlyphCode)).put("), ");
+      writer.put("Kern: ").putFixed(kern.kern).endl();
       i += 1;
     }
   } else {
-    stream << first << " None" << std::endl;
+    writer.put(first).put(" None").endl();
   }
 }
 
-auto IBMFFontDiff::showFaceHeader(std::ostream &stream, char first, FacePtr face) const -> void {
-
-  stream << first << " "
-         << "DPI: " << face->header->dpi << ", point siz: " << +face->header->pointSize
-         << ", linHght: " << +face->header->lineHeight
-         << ", xHght: " << +((float)face->header->xHeight / 64.0)
-         << ", emSiz: " << +((float)face->header->emSize / 64.0)
-         << ", spcSiz: " << +face->header->spaceSize << ", glyphCnt: " << +face->header->glyphCount
-         << ", LKCnt: " << +face->header->ligKernStepCount
-         << ", PixPoolSiz: " << +face->header->pixelsPoolSize
-         << ", slantCorr: " << +((float)face->header->slantCorrection / 64.0)
-         << ", descHght: " << +face->header->descenderHeight << std::endl;
+auto IBMFFontDiff::showFaceHeader(ReportWriter &writer, char first, FacePtr face) const -> void {
+  const FaceHeader &header = *face->header;
+
+  writer.put(first).put(" DPI: ").putInt(header.dpi);
+  writer.put(", point siz: ").putInt(header.pointSize);
+  writer.put(", linHght: ").putInt(header.lineHeight);
+  writer.put(", xHght: ").putFixed(header.xHeight);
+  writer.put(", emSiz: ").putFixed(header.emSize);
+  writer.put(", spcSiz: ").putInt(header.spaceSize);
+  writer.put(", glyphCnt: ").putInt(header.glyphCount);
+  writer.put(", LKCnt: ").putInt(header.ligKernStepCount);
+  writer.put(", PixPoolSiz: ").putInt(header.pixelsPoolSize);
+  writer.put(", slantCorr: ").putFixed(header.slantCorrection);
+  writer.put(", descHght: ").putInt(header.descenderHeight).endl();
 }
 
-auto IBMFFontDiff::showCodePointBundles(std::ostream &stream, char first, int firstIdx,
+auto IBMFFontDiff::showCodePointBundles(ReportWriter &writer, char first, int firstIdx,
                                         int count) const -> void {
   for (int idx = firstIdx; count > 0; idx++, count--) {
-    stream << first << " "
-           << "    [" << idx << "] "
-           << "First CodePoint: " << +codePointBundles_[idx].firstCodePoint
-           << ", Last CodePoint: " << +codePointBundles_[idx].lastCodePoint << std::endl;
+    writer.put(first).put("     [").putInt(idx).put("] ");
+    writer.put("First CodePoint: ").putInt(codePointBundles_[idx].firstCodePoint);
+    writer.put(", Last CodePoint: ").putInt(codePointBundles_[idx].lastCodePoint).endl();
   }
 }
 
-auto IBMFFontDiff::showPlanes(std::ostream &stream, char first) const -> void {
-  stream << "----------- Planes -----------" << std::endl;
+auto IBMFFontDiff::showPlanes(ReportWriter &writer, char first) const -> void {
+  writer.put("----------- Planes -----------").endl();
   for (int i = 0; i < 4; i++) {
-    stream << first << " "
-           << "[" << i << "] CodePoint Bundle Index: " << planes_[i].codePointBundlesIdx
-           << ", Entries Count: " << planes_[i].entriesCount
-           << ", First glyph code: " << planes_[i].firstGlyphCode << std::endl;
+    writer.put(first).put(" [").putInt(i).put("] CodePoint Bundle Index: ");
+    writer.putInt(planes_[i].codePointBundlesIdx);
+    writer.put(", Entries Count: ").putInt(planes_[i].entriesCount);
+    writer.put(", First glyph code: ").putInt(planes_[i].firstGlyphCode).endl();
     if (planes_[i].entriesCount > 0) {
-      stream << "    CodePoint Bundles:" << std::endl;
-      showCodePointBundles(stream, first, planes_[i].codePointBundlesIdx, planes_[i].entriesCount);
+      writer.put("    CodePoint Bundles:").endl();
+      showCodePointBundles(writer, first, planes_[i].codePointBundlesIdx, planes_[i].entriesCount);
     }
   }
 }
@@ -712,6 +911,6 @@ auto IBMFFontDiff::glyphIsModified(int faceIdx, GlyphCode glyphCode, BitmapPtr &
     -> bool {
   FacePtr face = faces_[faceIdx];
 
-  return !((*face->glyphs[glyphCode] == *glyphInfo) && (*face->bitmaps[glyphCode] == *bitmap) &&
-           (*face->glyphsLigKern[glyphCode] == *ligKern));
+  return !((face->glyphs[glyphCode] == *glyphInfo) && (*face->getBitmap(glyphCode) == *bitmap) &&
+           (face->glyphsLigKern[glyphCode] == GlyphLigKernView(*ligKern)));
 }
@@ -10,7 +10,12 @@
 
 using namespace IBMFDefs;
 
+#include "LigKernIndex.hpp"
+#include "LigKernProgram.hpp"
+#include "MappedFile.hpp"
+#include "MetricColumns.hpp"
 #include "RLEExtractor.hpp"
+#include "ReportWriter.hpp"
 
 #define DEBUG 0
 
@@ -33,25 +38,118 @@ typedef std::shared_ptr<IBMFFontDiff> IBMFFontDiffPtr;
 class IBMFFontDiff {
 public:
   struct Face {
-    FaceHeaderPtr                header;
-    std::vector<GlyphInfoPtr>    glyphs; // Not used with BAKCUP format
-    std::vector<BitmapPtr>       bitmaps;
-    std::vector<GlyphLigKernPtr> glyphsLigKern; // Specific to each glyph
-    // used ontly at save and load time
-    std::vector<RLEBitmapPtr> compressedBitmaps; // Todo: maybe unused at the end
+    FaceHeaderPtr header;
+    uint32_t      offset = 0;     // Location of the face in the font memory
+    uint32_t      size   = 0;     // Size of the face in the font memory
+    bool          loaded = false; // Glyphs retrieved, see IBMFFontDiff::prepareFace()
+
+    // Glyph records and RLE packets are views into the font memory. The lig/kern
+    // steps of all glyphs are decoded once in ligKernProgram, glyphsLigKern giving
+    // the view of each glyph.
+    ArrayView<GlyphInfo>          glyphs;            // Not used with BACKUP format
+    std::vector<RLEBitmap>        compressedBitmaps; // Packets in the pixels pool
+    std::vector<BitmapPtr>        bitmaps;           // Decompressed on demand, see getBitmap()
+    std::vector<GlyphLigKernView> glyphsLigKern;     // Specific to each glyph
+    LigKernProgram                ligKernProgram;    // Decoded ligKernSteps
+    MetricColumns                 metrics;           // Columns of the glyphs metrics
+    LigKernIndex                  ligKernIndex;      // (glyph, next glyph) pairs lookup
 
     // used only at save time
-    std::vector<LigKernStep> ligKernSteps; // The complete list of lig/kerns
+    const LigKernStep *ligKernSteps = nullptr; // The complete list of lig/kerns (in font memory)
+
+    // Only used with BACKUP format, in font memory
+    ArrayView<BackupGlyphInfo>          backupGlyphs;
+    std::vector<BackupGlyphLigKernView> backupGlyphsLigKern;
+
+    // Content hashes, computed at load time. A glyph hash covers its codePoint, its
+    // metrics (but ligKernPgmIndex), its RLE packet and its ligature/kerning steps.
+    // The face hash covers the face header and all glyph hashes.
+    std::vector<uint64_t> glyphHashes;
+    uint64_t              hash = 0;
+
+    // Frees the glyphs data, but the header and content hashes.
+    auto release() -> void;
+
+    // Returns the glyph bitmap, decompressing it from its RLE packet on first use.
+    auto getBitmap(GlyphCode glyphCode) -> BitmapPtr;
+
+    // Decompresses the glyph bitmap in any pixel resolution. The result is not cached.
+    template <PixelResolution RESOLUTION>
+    auto retrieveBitmap(GlyphCode glyphCode, BasicBitmap<RESOLUTION> &bitmap) const -> bool {
+      const RLEBitmap &compressedBitmap = compressedBitmaps[glyphCode];
+
+      bitmap.resize(compressedBitmap.dim);
+
+      BasicRLEExtractor<RESOLUTION> rle;
+      return rle.retrieveBitmap(compressedBitmap, bitmap, Pos(0, 0), getRLEMetrics(glyphCode));
+    }
+
+    // Returns the RLE metrics of the glyph, whatever the font format.
+    auto getRLEMetrics(GlyphCode glyphCode) const -> RLEMetrics;
 
-    // Only used with BACKUP format
-    std::vector<BackupGlyphInfoPtr>    backupGlyphs;
-    std::vector<BackupGlyphLigKernPtr> backupGlyphsLigKern;
+    // Compares the pixels of a glyph with a glyph of another face. When both RLE
+    // packets and their dynF/firstIsBlack metrics are identical, the bitmaps are
+    // equal without being decompressed. Otherwise, both bitmaps are decompressed
+    // and compared.
+    auto sameBitmap(GlyphCode glyphCode, Face &other, GlyphCode otherGlyphCode) -> bool;
   };
 
   typedef std::shared_ptr<Face> FacePtr;
 
-  IBMFFontDiff(uint8_t *memoryFont, uint32_t size) : memory_(memoryFont), memoryLength_(size) {
-    initialized_ = load();
+  // Content hashes of a face, as saved in a fingerprint cache.
+  struct FaceFingerprint {
+    uint8_t               pointSize;
+    uint64_t              hash;
+    std::vector<uint64_t> glyphHashes;
+  };
+
+  typedef std::vector<FaceFingerprint> Fingerprints;
+
+  // A ligature or kerning pair of a face, independent of the glyph codes and of
+  // the order of the lig/kern steps.
+  struct LigKernPair {
+    char32_t codePoint;     // First glyph of the pair
+    char32_t nextCodePoint; // Second glyph of the pair
+    bool     ligature;      // true = ligature, false = kerning
+    int32_t  value;         // Replacement codePoint, or kerning value (FIX16)
+
+    inline auto sameKey(const LigKernPair &other) const -> bool {
+      return (codePoint == other.codePoint) && (nextCodePoint == other.nextCodePoint) &&
+             (ligature == other.ligature);
+    }
+    inline auto keyLess(const LigKernPair &other) const -> bool {
+      if (codePoint != other.codePoint) return codePoint < other.codePoint;
+      if (nextCodePoint != other.nextCodePoint) return nextCodePoint < other.nextCodePoint;
+      return ligature < other.ligature;
+    }
+  };
+
+  typedef std::vector<LigKernPair> LigKernPairs;
+
+  // The font content is copied once in an internal buffer. The caller's memory
+  // can be released as soon as the constructor returns.
+  IBMFFontDiff(uint8_t *memoryFont, uint32_t size) : memoryLength_(size) {
+    std::shared_ptr<uint8_t[]> buffer(new uint8_t[size]);
+    memcpy(buffer.get(), memoryFont, size);
+    memoryOwner_ = buffer;
+    memory_      = buffer.get();
+    initialized_ = load(true);
+    lastError_   = 0;
+  }
+
+  // Zero-copy loading: faces headers, glyphs info, RLE packets and lig/kern steps
+  // are read-only views into the mapped file, kept alive as long as they are in use.
+  // When withHashes is false, the content hashes are left to zero, to be retrieved
+  // with setFingerprints() or computeHashes().
+  //
+  // When streaming is true, the faces are checked one at a time and their glyphs
+  // released once loaded: they must be retrieved with prepareFace() before use and
+  // can be released again with releaseFace(). The memory in use is then bounded by
+  // the prepared faces, not by the whole font.
+  IBMFFontDiff(MappedFilePtr mappedFile, bool withHashes = true, bool streaming = false)
+      : mappedFile_(mappedFile), memoryOwner_(mappedFile), memory_(mappedFile->getData()),
+        memoryLength_(mappedFile->getSize()), streaming_(streaming) {
+    initialized_ = load(withHashes);
     lastError_   = 0;
   }
 
@@ -82,26 +180,67 @@ public:
     return chCodes;
   }
 
+  inline auto getFaceHash(int faceIdx) const -> uint64_t {
+    return ((faceIdx >= 0) && (faceIdx < preamble_.faceCount)) ? faces_[faceIdx]->hash : 0;
+  }
+
+  inline auto getGlyphHash(int faceIdx, GlyphCode glyphCode) const -> uint64_t {
+    return ((faceIdx >= 0) && (faceIdx < preamble_.faceCount) &&
+            (glyphCode < faces_[faceIdx]->glyphHashes.size()))
+               ? faces_[faceIdx]->glyphHashes[glyphCode]
+               : 0;
+  }
+
+  // Retrieves the glyphs of a face released in streaming mode. Returns false if they
+  // cannot be retrieved.
+  auto prepareFace(Face &face) -> bool;
+  // Frees the glyphs of a face, as well as the font memory pages of the face when
+  // the font is a mapped file.
+  auto releaseFace(Face &face) -> void;
+  inline auto isStreaming() const -> bool { return streaming_; }
+
+  auto computeHashes() -> void;
+  auto getFingerprints() const -> Fingerprints;
+  // Returns false, with no change, if the fingerprints don't match the faces.
+  auto setFingerprints(Fingerprints &&fingerprints) -> bool;
+
+  // Returns true if translate(getUTF32(glyphCode)) == glyphCode for every glyphCode
+  // below glyphCount. Always false for the LATIN and BACKUP formats.
+  inline auto mapsGlyphCodes(int glyphCount) const -> bool {
+    return glyphCount <= mappedGlyphCount_;
+  }
+
+  // Returns the ligature and kerning pairs of a face, sorted on their codePoints.
+  // As for ligKern(), only the first step of a glyph for a given next glyph is kept.
+  auto getLigKernPairs(const Face &face) const -> LigKernPairs;
+
   auto findFace(uint8_t pointSize) -> FacePtr;
   auto findGlyphIndex(FacePtr face, char32_t codePoint) const -> int;
   auto ligKern(int faceIndex, const GlyphCode glyphCode1, GlyphCode *glyphCode2, FIX16 *kern,
                bool *kernPairPresent, GlyphLigKernPtr bypassLigKern = nullptr) const -> bool;
-  auto getGlyph(int faceIndex, int glyphCode, GlyphInfoPtr &glyphInfo, BitmapPtr &bitmap,
-                GlyphLigKernPtr &glyphLigKern) const -> bool;
+  // Retrieves the kerning between each pair of consecutive glyphs of a line of text:
+  // kerns[i] receives the kerning between glyphCodes[i] and glyphCodes[i + 1], or 0 if
+  // there is none. Ligatures are not considered. kerns must have room for count - 1
+  // values.
+  auto getKerns(int faceIndex, const GlyphCode *glyphCodes, int count, FIX16 *kerns) const
+      -> bool;
+  auto getGlyph(int faceIndex, int glyphCode, const GlyphInfo *&glyphInfo, BitmapPtr &bitmap,
+                GlyphLigKernView &glyphLigKern) const -> bool;
 
-  auto convertToOneBit(const Bitmap &bitmapHeightBits, BitmapPtr *bitmapOneBit) -> bool;
+  auto convertToOneBit(const EightBitsBitmap &bitmapHeightBits, OneBitBitmapPtr *bitmapOneBit)
+      -> bool;
   auto translate(char32_t codePoint) const -> GlyphCode;
   auto getUTF32(GlyphCode glyphCode) const -> char32_t;
   auto toGlyphCode(char32_t codePoint) const -> GlyphCode;
 
-  auto showBitmap(std::ostream &stream, char first, const BitmapPtr bitmap) const -> void;
-  auto showLigKerns(std::ostream &stream, char first, GlyphLigKernPtr lk) const -> void;
-  auto showGlyphInfo(std::ostream &stream, char first, GlyphCode i, const GlyphInfoPtr g) const
+  auto showBitmap(ReportWriter &writer, char first, const BitmapPtr bitmap) const -> void;
+  auto showLigKerns(ReportWriter &writer, char first, const GlyphLigKernView &lk) const -> void;
+  auto showGlyphInfo(ReportWriter &writer, char first, GlyphCode i, const GlyphInfo &g) const
       -> void;
-  auto showFaceHeader(std::ostream &stream, char first, FacePtr face) const -> void;
-  auto showCodePointBundles(std::ostream &stream, char first, int firstIdx, int count) const
+  auto showFaceHeader(ReportWriter &writer, char first, FacePtr face) const -> void;
+  auto showCodePointBundles(ReportWriter &writer, char first, int firstIdx, int count) const
       -> void;
-  auto showPlanes(std::ostream &stream, char first) const -> void;
+  auto showPlanes(ReportWriter &writer, char first) const -> void;
 
   auto glyphIsModified(int faceIdx, GlyphCode glyphCode, BitmapPtr &bitmap, GlyphInfoPtr &glyphInfo,
                        GlyphLigKernPtr &ligKern) const -> bool;
@@ -111,21 +250,36 @@ protected:
 
   Preamble preamble_;
 
-  std::vector<Plane>           planes_;
-  std::vector<CodePointBundle> codePointBundles_;
-  std::vector<FacePtr>         faces_;
+  const Plane           *planes_           = nullptr; // In font memory
+  const CodePointBundle *codePointBundles_ = nullptr; // In font memory
+  std::vector<FacePtr>   faces_;
+
+  // GlyphCode of the first codePoint of each bundle, for the codePoint lookup
+  std::vector<GlyphCode> bundlesFirstGlyphCode_;
+  // CodePoint of each glyphCode, for the reverse lookup
+  std::vector<char32_t> glyphCodePoints_;
+  // Number of leading glyphCodes retrieved through the translation of their codePoint
+  int mappedGlyphCount_ = 0;
 
 private:
   bool initialized_;
 
   std::vector<uint32_t> faceOffsets_;
 
-  uint8_t *memory_;
-  uint32_t memoryLength_;
+  MappedFilePtr               mappedFile_; // nullptr if the font is in an internal buffer
+  std::shared_ptr<const void> memoryOwner_;
+  const uint8_t              *memory_;
+  uint32_t                    memoryLength_;
+  bool                        streaming_ = false;
 
   int lastError_;
 
   auto findList(std::vector<LigKernStep> &pgm, std::vector<LigKernStep> &list) const -> int;
+  auto prepareCodePointIndex() -> void;
+  auto findGlyphCode(char32_t codePoint) const -> GlyphCode;
   auto prepareLigKernVectors() -> bool;
-  auto load() -> bool;
+  auto computeFaceHashes(Face &face) const -> void;
+  auto validate() const -> bool;
+  auto loadFace(Face &face) -> bool;
+  auto load(bool withHashes) -> bool;
 };
@@ -0,0 +1,115 @@
+#include "JsonReporter.hpp"
+
+#include <cstdio>
+
+static const char *kindNames[] = {"begin",              "end",                "faceCount",
+                                  "faceNotFound",       "faceHeader",         "glyphMetrics",
+                                  "glyphPixels",        "glyphLigKern",       "codePointNotFound",
+                                  "fontNotPaired",      "summary",            "ligKernPairAdded",
+                                  "ligKernPairRemoved", "ligKernPairChanged"};
+
+static_assert(sizeof(kindNames) / sizeof(kindNames[0]) == int(DiffKind::KIND_COUNT),
+              "kindNames table out of sync with DiffKind");
+
+auto JsonReporter::create(std::string &output) const -> DiffReporterPtr {
+  return DiffReporterPtr(new JsonReporter(output));
+}
+
+auto JsonReporter::writeString(const std::string &str) -> void {
+  stream_ << '"';
+  for (unsigned char ch : str) {
+    if ((ch == '"') || (ch == '\\')) {
+      stream_ << '\\' << ch;
+    } else if (ch < 0x20) {
+      char buffer[8];
+      snprintf(buffer, sizeof(buffer), "\\u%04x", ch);
+      stream_ << buffer;
+    } else {
+      stream_ << ch;
+    }
+  }
+  stream_ << '"';
+}
+
+auto JsonReporter::writeValue(DiffField field, int32_t value) -> void {
+  if (isFixedField(field)) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.10g", value / 64.0);
+    stream_ << buffer;
+  } else {
+    stream_ << value;
+  }
+}
+
+auto JsonReporter::begin(const std::string &path1, const std::string &path2) -> void {
+  stream_ << "{\"kind\":\"begin\",\"font1\":";
+  writeString(path1);
+  stream_ << ",\"font2\":";
+  writeString(path2);
+  stream_ << "}\n";
+}
+
+auto JsonReporter::end(int diffCount) -> void {
+  stream_ << "{\"kind\":\"end\",\"diffCount\":" << diffCount << "}\n";
+}
+
+auto JsonReporter::fontNotPaired(char side, const std::string &path) -> void {
+  stream_ << "{\"kind\":\"fontNotPaired\",\"side\":\"" << side << "\",\"path\":";
+  writeString(path);
+  stream_ << "}\n";
+}
+
+auto JsonReporter::summary(const DiffSummary &summary) -> void {
+  stream_ << "{\"kind\":\"summary\",\"pairsCompared\":" << summary.pairsCompared
+          << ",\"identicalPairs\":" << summary.identicalPairs
+          << ",\"differentPairs\":" << summary.differentPairs
+          << ",\"failedPairs\":" << summary.failedPairs
+          << ",\"unpairedFonts\":" << summary.unpairedFonts
+          << ",\"diffCount\":" << summary.diffCount << "}\n";
+}
+
+auto JsonReporter::writeRecord(const DiffRecord &record) -> void {
+  stream_ << "{\"kind\":\"" << kindNames[int(record.kind)] << '"';
+
+  if (record.side != 0) stream_ << ",\"side\":\"" << record.side << '"';
+  if (record.kind != DiffKind::FACE_COUNT) stream_ << ",\"pointSize\":" << +record.pointSize;
+
+  switch (record.kind) {
+    case DiffKind::GLYPH_METRICS:
+    case DiffKind::CODE_POINT_NOT_FOUND:
+      stream_ << ",\"codePoint\":" << uint32_t(record.codePoint);
+      break;
+    case DiffKind::GLYPH_PIXELS:
+      stream_ << ",\"codePoint\":" << uint32_t(record.codePoint)
+              << ",\"changedPixels\":" << record.count;
+      break;
+    case DiffKind::GLYPH_LIG_KERN:
+      stream_ << ",\"codePoint\":" << uint32_t(record.codePoint)
+              << ",\"changedSteps\":" << record.count;
+      break;
+    case DiffKind::LIG_KERN_PAIR_ADDED:
+    case DiffKind::LIG_KERN_PAIR_REMOVED:
+    case DiffKind::LIG_KERN_PAIR_CHANGED:
+      stream_ << ",\"codePoint\":" << uint32_t(record.codePoint)
+              << ",\"nextCodePoint\":" << uint32_t(record.nextCodePoint);
+      break;
+    default:
+      break;
+  }
+
+  if (!record.deltas.empty()) {
+    stream_ << ",\"deltas\":{";
+    bool first = true;
+    for (auto &delta : record.deltas) {
+      if (!first) stream_ << ',';
+      stream_ << '"' << fieldName(delta.field) << "\":[";
+      writeValue(delta.field, delta.value1);
+      stream_ << ',';
+      writeValue(delta.field, delta.value2);
+      stream_ << ']';
+      first = false;
+    }
+    stream_ << '}';
+  }
+  stream_ << "}\n";
+}
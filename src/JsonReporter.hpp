@@ -0,0 +1,37 @@
+#pragma once
+
+#include "DiffReporter.hpp"
+
+/**
+ * @brief JSON Lines report.
+ *
+ * Every difference is written as a single line JSON object as soon as it is
+ * reported, for example:
+ *
+ * {"kind":"glyphMetrics","pointSize":14,"codePoint":33,"deltas":{"dynF":[13,12]}}
+ *
+ * The deltas object maps each field that differs to its values in both fonts.
+ * The FIX16 fields (advance, xHeight, emSize, slantCorrection) are converted to
+ * pixels. The side of the not found kinds is "<" or ">" (see DiffReporter).
+ *
+ */
+class JsonReporter : public RecordReporter {
+public:
+  JsonReporter(std::ostream &stream) : RecordReporter(stream) {}
+  JsonReporter(std::string &output) : RecordReporter(output) {}
+
+  auto create(std::string &output) const -> DiffReporterPtr override;
+
+  auto begin(const std::string &path1, const std::string &path2) -> void override;
+  auto end(int diffCount) -> void override;
+
+  auto fontNotPaired(char side, const std::string &path) -> void override;
+  auto summary(const DiffSummary &summary) -> void override;
+
+protected:
+  auto writeRecord(const DiffRecord &record) -> void override;
+
+private:
+  auto writeString(const std::string &str) -> void;
+  auto writeValue(DiffField field, int32_t value) -> void;
+};
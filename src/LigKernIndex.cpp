@@ -0,0 +1,80 @@
+#include "LigKernIndex.hpp"
+
+#include <algorithm>
+
+// Appends the steps of a glyph, sorted on nextGlyphCode, with only the first
+// one kept for a given nextGlyphCode.
+template <typename Step, typename GetValue>
+auto LigKernIndex::appendSorted(const ArrayView<Step> &steps, GetValue getValue,
+                                std::vector<Pair> &pairs) -> void {
+  size_t first = pairs.size();
+
+  for (auto &step : steps) {
+    pairs.push_back({step.nextGlyphCode, getValue(step)});
+  }
+  std::stable_sort(pairs.begin() + first, pairs.end(), [](const auto &a, const auto &b) {
+    return a.nextGlyphCode < b.nextGlyphCode;
+  });
+  auto last = std::unique(pairs.begin() + first, pairs.end(), [](const auto &a, const auto &b) {
+    return a.nextGlyphCode == b.nextGlyphCode;
+  });
+  pairs.erase(last, pairs.end());
+}
+
+auto LigKernIndex::build(const std::vector<GlyphLigKernView> &glyphsLigKern) -> void {
+  clear();
+
+  ligStart_.reserve(glyphsLigKern.size() + 1);
+  kernStart_.reserve(glyphsLigKern.size() + 1);
+
+  for (auto &ligKern : glyphsLigKern) {
+    ligStart_.push_back(ligs_.size());
+    kernStart_.push_back(kerns_.size());
+    appendSorted(
+        ligKern.ligSteps, [](const GlyphLigStep &step) { return step.replacementGlyphCode; },
+        ligs_);
+    appendSorted(
+        ligKern.kernSteps, [](const GlyphKernStep &step) { return uint16_t(step.kern); }, kerns_);
+  }
+  ligStart_.push_back(ligs_.size());
+  kernStart_.push_back(kerns_.size());
+}
+
+auto LigKernIndex::clear() -> void {
+  ligStart_.clear();
+  kernStart_.clear();
+  ligs_.clear();
+  kerns_.clear();
+}
+
+auto LigKernIndex::find(const std::vector<uint32_t> &start, const std::vector<Pair> &pairs,
+                        GlyphCode glyphCode, GlyphCode nextGlyphCode) -> const Pair * {
+  if (size_t(glyphCode) + 1 >= start.size()) return nullptr;
+
+  auto first = pairs.begin() + start[glyphCode];
+  auto last  = pairs.begin() + start[glyphCode + 1];
+  auto it    = std::lower_bound(first, last, nextGlyphCode, [](const Pair &pair, GlyphCode code) {
+    return pair.nextGlyphCode < code;
+  });
+
+  return ((it != last) && (it->nextGlyphCode == nextGlyphCode)) ? &*it : nullptr;
+}
+
+auto LigKernIndex::findLigature(GlyphCode glyphCode, GlyphCode nextGlyphCode,
+                                GlyphCode &replacement) const -> bool {
+  const Pair *pair = find(ligStart_, ligs_, glyphCode, nextGlyphCode);
+  if (pair == nullptr) return false;
+
+  replacement = pair->value;
+  return true;
+}
+
+auto LigKernIndex::findKern(GlyphCode glyphCode, GlyphCode nextGlyphCode, FIX16 &kern) const
+    -> bool {
+  const Pair *pair = find(kernStart_, kerns_, glyphCode, nextGlyphCode);
+  if (pair == nullptr) return false;
+
+  kern = pair->value;
+  if (kern & 0x2000) kern |= 0xC000;
+  return true;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cinttypes>
+#include <vector>
+
+#include "IBMFDefs.hpp"
+
+using namespace IBMFDefs;
+
+/**
+ * @brief Ligature and kerning pairs index of a face.
+ *
+ * The steps of every glyph are kept sorted on their next glyph code, such that a
+ * (glyph, next glyph) pair is retrieved with a binary search in the steps of
+ * the glyph only. As with a linear scan of the steps, the first step of a glyph
+ * for a given next glyph code is the one retained.
+ *
+ */
+class LigKernIndex {
+public:
+  // Builds the index from the lig/kern steps of each glyph of a face.
+  auto build(const std::vector<GlyphLigKernView> &glyphsLigKern) -> void;
+  auto clear() -> void;
+
+  // Returns true if a ligature exists between glyphCode and nextGlyphCode, with
+  // the replacing glyph code in replacement.
+  auto findLigature(GlyphCode glyphCode, GlyphCode nextGlyphCode, GlyphCode &replacement) const
+      -> bool;
+
+  // Returns true if a kerning exists between glyphCode and nextGlyphCode, with
+  // its value, sign extended from the 14 bits stored in the font, in kern.
+  auto findKern(GlyphCode glyphCode, GlyphCode nextGlyphCode, FIX16 &kern) const -> bool;
+
+  // Returns true if glyphCode has at least one ligature or kerning step.
+  inline auto hasSteps(GlyphCode glyphCode) const -> bool {
+    return (size_t(glyphCode) + 1 < ligStart_.size()) &&
+           ((ligStart_[glyphCode] != ligStart_[glyphCode + 1]) ||
+            (kernStart_[glyphCode] != kernStart_[glyphCode + 1]));
+  }
+
+private:
+  struct Pair {
+    GlyphCode nextGlyphCode;
+    uint16_t  value; // Replacement glyph code or kerning value
+  };
+
+  // Steps of glyph g are at [start[g], start[g + 1])
+  std::vector<uint32_t> ligStart_, kernStart_;
+  std::vector<Pair>     ligs_, kerns_;
+
+  template <typename Step, typename GetValue>
+  static auto appendSorted(const ArrayView<Step> &steps, GetValue getValue,
+                           std::vector<Pair> &pairs) -> void;
+  static auto find(const std::vector<uint32_t> &start, const std::vector<Pair> &pairs,
+                   GlyphCode glyphCode, GlyphCode nextGlyphCode) -> const Pair *;
+};
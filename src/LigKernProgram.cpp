@@ -0,0 +1,76 @@
+#include "LigKernProgram.hpp"
+
+// A goTo step is only followed when it is the entry of a glyph. Elsewhere in a
+// sequence, it is decoded as a kerning step, as with the original decoder.
+auto LigKernProgram::compile(const LigKernStep *steps, int stepCount, int glyphCount) -> bool {
+  clear();
+
+  steps_ = steps;
+  firstLig_.resize(stepCount + 1);
+  firstKern_.resize(stepCount + 1);
+  stopIdx_.resize(stepCount);
+
+  for (int idx = 0; idx < stepCount; idx++) {
+    const LigKernStep &step = steps[idx];
+
+    firstLig_[idx]  = ligSteps_.size();
+    firstKern_[idx] = kernSteps_.size();
+
+    if (isAGoTo(step)) {
+      if (step.b.goTo.displacement >= stepCount) {
+        clear();
+        return false;
+      }
+    } else if (step.a.data.nextGlyphCode >= glyphCount) {
+      clear();
+      return false;
+    }
+
+    if (step.b.kern.isAKern) { // true = kern, false = ligature
+      kernSteps_.push_back(GlyphKernStep{.nextGlyphCode = step.a.data.nextGlyphCode,
+                                         .kern          = step.b.kern.kerningValue});
+    } else {
+      if (step.b.repl.replGlyphCode >= glyphCount) {
+        clear();
+        return false;
+      }
+      ligSteps_.push_back(GlyphLigStep{.nextGlyphCode        = step.a.data.nextGlyphCode,
+                                       .replacementGlyphCode = step.b.repl.replGlyphCode});
+    }
+  }
+  firstLig_[stepCount]  = ligSteps_.size();
+  firstKern_[stepCount] = kernSteps_.size();
+
+  // The sequences ending, from the last step backward
+  int32_t stopIdx = -1;
+  for (int idx = stepCount - 1; idx >= 0; idx--) {
+    if (steps[idx].a.data.stop) stopIdx = idx;
+    stopIdx_[idx] = stopIdx;
+  }
+
+  return true;
+}
+
+auto LigKernProgram::clear() -> void {
+  steps_ = nullptr;
+  ligSteps_.clear();
+  kernSteps_.clear();
+  firstLig_.clear();
+  firstKern_.clear();
+  stopIdx_.clear();
+}
+
+auto LigKernProgram::getGlyphLigKern(int pgmIndex, GlyphLigKernView &ligKern) const -> bool {
+  if ((pgmIndex < 0) || (pgmIndex >= getStepCount())) return false;
+
+  int first = isAGoTo(steps_[pgmIndex]) ? steps_[pgmIndex].b.goTo.displacement : pgmIndex;
+  int last  = stopIdx_[first];
+  if (last < 0) return false;
+
+  ligKern = GlyphLigKernView(
+      ArrayView<GlyphLigStep>(ligSteps_.data() + firstLig_[first],
+                              firstLig_[last + 1] - firstLig_[first]),
+      ArrayView<GlyphKernStep>(kernSteps_.data() + firstKern_[first],
+                               firstKern_[last + 1] - firstKern_[first]));
+  return true;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cinttypes>
+#include <vector>
+
+#include "IBMFDefs.hpp"
+
+using namespace IBMFDefs;
+
+/**
+ * @brief Decoded ligature/kerning program of a face.
+ *
+ * The program of a face is a table of LigKernStep, each glyph starting its
+ * execution at its ligKernPgmIndex (through a goTo step when the index is too
+ * large for a byte) and ending at the first step with the stop flag. The
+ * sequences of many glyphs are shared tails of the same steps.
+ *
+ * The whole program is validated and decoded once, in a single pass: the
+ * ligature and kerning steps are kept in program order, such that the steps
+ * executed from any entry are a contiguous slice of the decoded steps. All
+ * glyphs starting in the same sequence share its decoded steps, without
+ * walking them again.
+ *
+ */
+class LigKernProgram {
+public:
+  // Validates and decodes the steps. Returns false, with an empty program, if a
+  // glyph code or goTo displacement is out of bounds.
+  auto compile(const LigKernStep *steps, int stepCount, int glyphCount) -> bool;
+  auto clear() -> void;
+
+  // Retrieves the steps executed from the pgmIndex entry. Returns false if the
+  // entry is out of bounds, or if its execution would not end with a stop flag.
+  auto getGlyphLigKern(int pgmIndex, GlyphLigKernView &ligKern) const -> bool;
+
+  inline auto getStepCount() const -> int { return firstLig_.empty() ? 0 : firstLig_.size() - 1; }
+
+private:
+  const LigKernStep *steps_ = nullptr;
+
+  std::vector<GlyphLigStep>  ligSteps_;
+  std::vector<GlyphKernStep> kernSteps_;
+
+  // For step i: index of its first decoded steps (i + 1 being the end of step i),
+  // and index of the stop step ending its sequence, or -1 if there is none.
+  std::vector<uint32_t> firstLig_, firstKern_;
+  std::vector<int32_t>  stopIdx_;
+
+  static inline auto isAGoTo(const LigKernStep &step) -> bool {
+    return step.b.goTo.isAGoTo && step.b.goTo.isAKern;
+  }
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cinttypes>
+#include <memory>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+class MappedFile;
+
+typedef std::shared_ptr<MappedFile> MappedFilePtr;
+
+/**
+ * @brief Read-only memory mapping of a whole file.
+ *
+ * The mapping stays valid for the lifetime of the instance. IBMFFontDiff keeps a
+ * reference to it so that its faces, glyph records and RLE packets can point
+ * directly into the file content without being copied.
+ *
+ */
+class MappedFile {
+public:
+  MappedFile(const char *filename)
+      : data_(nullptr), size_(0), modificationTime_(0), device_(0), inode_(0) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return;
+
+    struct stat st;
+    if ((fstat(fd, &st) == 0) && (st.st_size > 0) && (st.st_size <= UINT32_MAX)) {
+      void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr != MAP_FAILED) {
+        data_             = static_cast<uint8_t *>(addr);
+        size_             = st.st_size;
+        modificationTime_ = int64_t(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+        device_           = st.st_dev;
+        inode_            = st.st_ino;
+      }
+    }
+    close(fd);
+  }
+
+  ~MappedFile() {
+    if (data_ != nullptr) munmap(data_, size_);
+  }
+
+  MappedFile(const MappedFile &)            = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  inline auto isMapped() const -> bool { return data_ != nullptr; }
+  inline auto getData() const -> uint8_t * { return data_; }
+  inline auto getSize() const -> uint32_t { return size_; }
+
+  // Tells the system that the pages of a range are not needed anymore. They are
+  // read again from the file on the next access.
+  inline auto release(uint32_t offset, uint32_t size) const -> void {
+    if ((data_ == nullptr) || (size == 0)) return;
+
+    uintptr_t pageSize = sysconf(_SC_PAGESIZE);
+    uintptr_t first    = reinterpret_cast<uintptr_t>(data_ + offset) & ~(pageSize - 1);
+    uintptr_t last     = reinterpret_cast<uintptr_t>(data_ + offset + size);
+    madvise(reinterpret_cast<void *>(first), last - first, MADV_DONTNEED);
+  }
+
+  // In nanoseconds since the epoch, as retrieved when the file was mapped.
+  inline auto getModificationTime() const -> int64_t { return modificationTime_; }
+
+  // Identity of the file in its file system.
+  inline auto getDevice() const -> uint64_t { return device_; }
+  inline auto getInode() const -> uint64_t { return inode_; }
+
+private:
+  uint8_t *data_;
+  uint32_t size_;
+  int64_t  modificationTime_;
+  uint64_t device_;
+  uint64_t inode_;
+};
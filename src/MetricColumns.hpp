@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+#include <vector>
+
+#if defined(__SSE2__)
+  #include <emmintrin.h>
+#endif
+
+#include "IBMFDefs.hpp"
+
+using namespace IBMFDefs;
+
+/**
+ * @brief Glyph metrics of a face, stored as one column per field.
+ *
+ * The columns hold the fields considered by GlyphInfo::operator==(), such that
+ * the metrics of consecutive glyphs of two faces can be compared a whole column
+ * at a time. The RLE metrics are kept as their raw byte, all of its bits being
+ * compared.
+ *
+ */
+struct MetricColumns {
+  std::vector<uint8_t>  bitmapWidth;
+  std::vector<uint8_t>  bitmapHeight;
+  std::vector<uint8_t>  horizontalOffset;
+  std::vector<uint8_t>  verticalOffset;
+  std::vector<uint8_t>  rleMetrics;
+  std::vector<uint16_t> packetLength;
+  std::vector<uint16_t> advance;
+  std::vector<uint16_t> mainCode;
+
+  auto assign(const ArrayView<GlyphInfo> &glyphs) -> void {
+    resize(glyphs.size());
+    for (size_t idx = 0; idx < glyphs.size(); idx++) {
+      const GlyphInfo &glyph = glyphs[idx];
+
+      bitmapWidth[idx]      = glyph.bitmapWidth;
+      bitmapHeight[idx]     = glyph.bitmapHeight;
+      horizontalOffset[idx] = glyph.horizontalOffset;
+      verticalOffset[idx]   = glyph.verticalOffset;
+      rleMetrics[idx]       = *reinterpret_cast<const uint8_t *>(&glyph.rleMetrics);
+      packetLength[idx]     = glyph.packetLength;
+      advance[idx]          = glyph.advance;
+      mainCode[idx]         = glyph.mainCode;
+    }
+  }
+
+  auto clear() -> void { resize(0); }
+
+  inline auto size() const -> size_t { return mainCode.size(); }
+
+private:
+  auto resize(size_t count) -> void {
+    bitmapWidth.resize(count);
+    bitmapHeight.resize(count);
+    horizontalOffset.resize(count);
+    verticalOffset.resize(count);
+    rleMetrics.resize(count);
+    packetLength.resize(count);
+    advance.resize(count);
+    mainCode.resize(count);
+  }
+};
+
+static_assert(sizeof(RLEMetrics) == 1, "RLEMetrics is expected to be a single byte");
+
+// Bulk metrics comparison kernels. Bit i of mask is set when the metrics of glyph
+// first1 + i of the first face differ from the ones of glyph first2 + i of the
+// second face. They are vectorized with SSE2 when the compiler targets it, the
+// remaining tail glyphs being processed one at a time.
+
+namespace MetricColumnsCompare {
+
+// Number of 64 bits mask words needed for count glyphs.
+inline constexpr auto maskSize(int count) -> int { return (count + 63) / 64; }
+
+inline auto markDiffer(const uint8_t *a, const uint8_t *b, int count, uint64_t *mask) -> void {
+  int idx = 0;
+
+#if defined(__SSE2__)
+  for (; idx + 16 <= count; idx += 16) {
+    __m128i  va   = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + idx));
+    __m128i  vb   = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + idx));
+    uint64_t bits = ~_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) & 0xFFFF;
+    mask[idx >> 6] |= bits << (idx & 63);
+  }
+#endif
+
+  for (; idx < count; idx++) {
+    if (a[idx] != b[idx]) mask[idx >> 6] |= uint64_t(1) << (idx & 63);
+  }
+}
+
+inline auto markDiffer(const uint16_t *a, const uint16_t *b, int count, uint64_t *mask) -> void {
+  int idx = 0;
+
+#if defined(__SSE2__)
+  for (; idx + 16 <= count; idx += 16) {
+    __m128i va0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + idx));
+    __m128i vb0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + idx));
+    __m128i va1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + idx + 8));
+    __m128i vb1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + idx + 8));
+    // Both 16 bits comparison results are narrowed to one byte per glyph
+    __m128i  same = _mm_packs_epi16(_mm_cmpeq_epi16(va0, vb0), _mm_cmpeq_epi16(va1, vb1));
+    uint64_t bits = ~_mm_movemask_epi8(same) & 0xFFFF;
+    mask[idx >> 6] |= bits << (idx & 63);
+  }
+#endif
+
+  for (; idx < count; idx++) {
+    if (a[idx] != b[idx]) mask[idx >> 6] |= uint64_t(1) << (idx & 63);
+  }
+}
+
+// Compares count consecutive glyphs of both faces. The maskSize(count) words of
+// mask are overwritten.
+inline auto metricsDiffer(const MetricColumns &metrics1, GlyphCode first1,
+                          const MetricColumns &metrics2, GlyphCode first2, int count,
+                          uint64_t *mask) -> void {
+  for (int idx = 0; idx < maskSize(count); idx++) mask[idx] = 0;
+  if (count <= 0) return;
+
+  markDiffer(&metrics1.bitmapWidth[first1], &metrics2.bitmapWidth[first2], count, mask);
+  markDiffer(&metrics1.bitmapHeight[first1], &metrics2.bitmapHeight[first2], count, mask);
+  markDiffer(&metrics1.horizontalOffset[first1], &metrics2.horizontalOffset[first2], count, mask);
+  markDiffer(&metrics1.verticalOffset[first1], &metrics2.verticalOffset[first2], count, mask);
+  markDiffer(&metrics1.rleMetrics[first1], &metrics2.rleMetrics[first2], count, mask);
+  markDiffer(&metrics1.packetLength[first1], &metrics2.packetLength[first2], count, mask);
+  markDiffer(&metrics1.advance[first1], &metrics2.advance[first2], count, mask);
+  markDiffer(&metrics1.mainCode[first1], &metrics2.mainCode[first2], count, mask);
+}
+
+} // namespace MetricColumnsCompare
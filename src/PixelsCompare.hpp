@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+#include <cstring>
+
+#if defined(__AVX2__)
+  #include <immintrin.h>
+#elif defined(__SSE2__)
+  #include <emmintrin.h>
+#endif
+
+// Pixel arrays comparison kernels used by the bitmaps. They are vectorized
+// with AVX2 or SSE2 when the compiler targets them, and fall back to 64 bits
+// words otherwise. The remaining tail bytes are always processed one at a time.
+
+namespace PixelsCompare {
+
+#if defined(__AVX2__)
+const constexpr size_t VECTOR_SIZE = 32;
+#elif defined(__SSE2__)
+const constexpr size_t VECTOR_SIZE = 16;
+#else
+const constexpr size_t VECTOR_SIZE = 8;
+#endif
+
+// Returns true if the size bytes at a and b are identical.
+inline auto equal(const uint8_t *a, const uint8_t *b, size_t size) -> bool {
+  size_t idx = 0;
+
+#if defined(__AVX2__)
+  for (; idx + VECTOR_SIZE <= size; idx += VECTOR_SIZE) {
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + idx));
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + idx));
+    if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb)) != -1) return false;
+  }
+#elif defined(__SSE2__)
+  for (; idx + VECTOR_SIZE <= size; idx += VECTOR_SIZE) {
+    __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + idx));
+    __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + idx));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) != 0xFFFF) return false;
+  }
+#else
+  for (; idx + VECTOR_SIZE <= size; idx += VECTOR_SIZE) {
+    uint64_t wa, wb;
+    memcpy(&wa, a + idx, VECTOR_SIZE);
+    memcpy(&wb, b + idx, VECTOR_SIZE);
+    if (wa != wb) return false;
+  }
+#endif
+
+  for (; idx < size; idx++) {
+    if (a[idx] != b[idx]) return false;
+  }
+  return true;
+}
+
+// Computes a ^ b into mask (when not nullptr) and returns the number of bytes
+// that differ. This is the count of changed pixels for eight bits pixels.
+inline auto xorCountBytes(const uint8_t *a, const uint8_t *b, size_t size, uint8_t *mask)
+    -> uint32_t {
+  uint32_t count = 0;
+  size_t   idx   = 0;
+
+#if defined(__AVX2__)
+  const __m256i zero = _mm256_setzero_si256();
+  for (; idx + VECTOR_SIZE <= size; idx += VECTOR_SIZE) {
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + idx));
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + idx));
+    __m256i vx = _mm256_xor_si256(va, vb);
+    if (mask != nullptr) _mm256_storeu_si256(reinterpret_cast<__m256i *>(mask + idx), vx);
+    uint32_t same = _mm256_movemask_epi8(_mm256_cmpeq_epi8(vx, zero));
+    count += VECTOR_SIZE - __builtin_popcount(same);
+  }
+#elif defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  for (; idx + VECTOR_SIZE <= size; idx += VECTOR_SIZE) {
+    __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + idx));
+    __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + idx));
+    __m128i vx = _mm_xor_si128(va, vb);
+    if (mask != nullptr) _mm_storeu_si128(reinterpret_cast<__m128i *>(mask + idx), vx);
+    uint32_t same = _mm_movemask_epi8(_mm_cmpeq_epi8(vx, zero));
+    count += VECTOR_SIZE - __builtin_popcount(same);
+  }
+#endif
+
+  for (; idx < size; idx++) {
+    uint8_t x = a[idx] ^ b[idx];
+    if (mask != nullptr) mask[idx] = x;
+    if (x != 0) count++;
+  }
+  return count;
+}
+
+// Computes a ^ b into mask (when not nullptr) and returns the number of bits
+// that differ. This is the count of changed pixels for one bit pixels.
+inline auto xorCountBits(const uint8_t *a, const uint8_t *b, size_t size, uint8_t *mask)
+    -> uint32_t {
+  uint32_t count = 0;
+  size_t   idx   = 0;
+
+  for (; idx + 8 <= size; idx += 8) {
+    uint64_t wa, wb;
+    memcpy(&wa, a + idx, 8);
+    memcpy(&wb, b + idx, 8);
+    uint64_t wx = wa ^ wb;
+    if (mask != nullptr) memcpy(mask + idx, &wx, 8);
+    count += __builtin_popcountll(wx);
+  }
+
+  for (; idx < size; idx++) {
+    uint8_t x = a[idx] ^ b[idx];
+    if (mask != nullptr) mask[idx] = x;
+    count += __builtin_popcount(x);
+  }
+  return count;
+}
+
+} // namespace PixelsCompare
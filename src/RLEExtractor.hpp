@@ -8,11 +8,59 @@
 
 using namespace IBMFDefs;
 
-class RLEExtractor {
+// Byte-at-a-time decoding of PK packed numbers. For each dynF value (0..13) and
+// each byte value, the table tells which run lengths are fully decoded from the
+// byte when it is read starting on its high nybble. A count of 0 means that the
+// high nybble starts a large number or a repeat count: these are decoded one
+// nybble at a time.
+
+struct PackedByte {
+  uint8_t count;   // Number of run lengths decoded from the byte (0, 1 or 2)
+  uint8_t nybbles; // Nybbles used by these run lengths (1 or 2)
+  uint8_t run[2];  // The run lengths
+};
+
+struct PackedByteTables {
+  PackedByte dynF[14][256];
+};
+
+constexpr auto buildPackedByteTables() -> PackedByteTables {
+  PackedByteTables tables{};
+  for (int dynF = 0; dynF < 14; dynF++) {
+    for (int byte = 0; byte < 256; byte++) {
+      PackedByte &entry = tables.dynF[dynF][byte];
+      int         hi    = byte >> 4;
+      int         lo    = byte & 0x0f;
+      if ((hi >= 1) && (hi <= dynF)) {
+        entry.run[0]  = hi;
+        entry.count   = 1;
+        entry.nybbles = 1;
+        if ((lo >= 1) && (lo <= dynF)) {
+          entry.run[1]  = lo;
+          entry.count   = 2;
+          entry.nybbles = 2;
+        }
+      } else if ((hi > dynF) && (hi < 14)) {
+        entry.run[0]  = ((hi - dynF - 1) << 4) + lo + dynF + 1;
+        entry.count   = 1;
+        entry.nybbles = 2;
+      }
+    }
+  }
+  return tables;
+}
+
+inline constexpr PackedByteTables packedBytes = buildPackedByteTables();
+
+// Decompression of RLE bitmaps. The output pixel resolution is selected at
+// compile time: RLEExtractor is using the default resolution.
+
+template <PixelResolution RESOLUTION> class BasicRLEExtractor {
 private:
   uint32_t repeatCount;
+  uint32_t pendingRun; // Second run length decoded from the last byte, 0 if none
 
-  MemoryPtr memoryPtr, memoryEnd;
+  const uint8_t *memoryPtr, *memoryEnd;
 
   const uint8_t PK_REPEAT_COUNT = 14;
   const uint8_t PK_REPEAT_ONCE  = 15;
@@ -68,47 +116,66 @@ private:
   //   end;
   // end;
 
-  bool getPackedNumber(uint32_t &val, const RLEMetrics &rleMetrics) {
-    uint8_t  nyb;
-    uint32_t i, j;
+  // Decodes the nybbles following the first one of a packed number that is not
+  // a repeat count indicator.
+  template <uint8_t DYN_F> bool getPackedValue(uint8_t nyb, uint32_t &val) {
+    uint32_t i = nyb, j;
 
-    uint8_t dynF = rleMetrics.dynF;
+    if (i == 0) {
+      do {
+        if (!getNybble(nyb)) return false;
+        i++;
+      } while (nyb == 0);
+      j = nyb;
+      while (i-- > 0) {
+        if (!getNybble(nyb)) return false;
+        j = (j << 4) + nyb;
+      }
+      val = j - 15 + ((13 - DYN_F) << 4) + DYN_F;
+    } else if (i <= DYN_F) {
+      val = i;
+    } else {
+      if (!getNybble(nyb)) return false;
+      val = ((i - DYN_F - 1) << 4) + nyb + DYN_F + 1;
+    }
+    return true;
+  }
+
+  template <uint8_t DYN_F> bool getPackedNumber(uint32_t &val) {
+    if (pendingRun != 0) {
+      val        = pendingRun;
+      pendingRun = 0;
+      return true;
+    }
 
     while (true) {
-      if (!getNybble(nyb)) return false;
-      i = nyb;
-      if (i == 0) {
-        do {
-          if (!getNybble(nyb)) return false;
-          i++;
-        } while (nyb == 0);
-        j = nyb;
-        while (i-- > 0) {
-          if (!getNybble(nyb)) return false;
-          j = (j << 4) + nyb;
-        }
-        val = j - 15 + ((13 - dynF) << 4) + dynF;
-        break;
-      } else if (i <= dynF) {
-        val = i;
-        break;
-      } else if (i < PK_REPEAT_COUNT) {
-        if (!getNybble(nyb)) return false;
-        val = ((i - dynF - 1) << 4) + nyb + dynF + 1;
-        break;
-      } else {
-        // if (repeatCount != 0) {
-        //   std::cerr << "Spurious repeatCount iteration!" << std::endl;
-        //   return false;
-        // }
-        if (i == PK_REPEAT_COUNT) {
-          if (!getPackedNumber(repeatCount, rleMetrics)) return false;
-        } else { // i == PK_REPEAT_ONCE
-          repeatCount = 1;
+      // Fast path: small run lengths are retrieved a whole byte at a time
+      if ((nybbleFlipper == 0xf0U) && (memoryPtr < memoryEnd)) {
+        const PackedByte &entry = packedBytes.dynF[DYN_F][*memoryPtr];
+        if (entry.count > 0) {
+          val = entry.run[0];
+          if (entry.count == 2) {
+            pendingRun = entry.run[1];
+          } else if (entry.nybbles == 1) {
+            nybbleByte    = *memoryPtr;
+            nybbleFlipper = 0x0fU;
+          }
+          memoryPtr++;
+          return true;
         }
       }
+
+      uint8_t nyb;
+      if (!getNybble(nyb)) return false;
+      if (nyb < PK_REPEAT_COUNT) return getPackedValue<DYN_F>(nyb, val);
+
+      if (nyb == PK_REPEAT_COUNT) {
+        if (!getNybble(nyb) || (nyb >= PK_REPEAT_COUNT)) return false;
+        if (!getPackedValue<DYN_F>(nyb, repeatCount)) return false;
+      } else { // nyb == PK_REPEAT_ONCE
+        repeatCount = 1;
+      }
     }
-    return true;
   }
 
   inline void copyOneRowEightBits(MemoryPtr fromLine, MemoryPtr toLine, int16_t fromCol,
@@ -117,160 +184,208 @@ private:
   }
 
   void copyOneRowOneBit(MemoryPtr fromLine, MemoryPtr toLine, int16_t fromCol, int size) const {
-    uint8_t mask = 0x80 >> (fromCol & 7);
-    for (int col = fromCol; col < fromCol + size; col++) {
+    int first = fromCol >> 3;
+    int last  = (fromCol + size - 1) >> 3;
+    for (int idx = first; idx <= last; idx++) {
+      uint8_t mask = 0xFF;
+      if (idx == first) mask &= 0xFF >> (fromCol & 7);
+      if (idx == last) mask &= 0xFF << (7 - ((fromCol + size - 1) & 7));
       if constexpr (BLACK_ONE_BIT) {
-        toLine[col >> 3] |= (fromLine[col >> 3] & mask);
+        toLine[idx] |= (fromLine[idx] & mask);
       } else {
-        toLine[col >> 3] &= fromLine[col >> 3] | ~mask;
+        toLine[idx] &= fromLine[idx] | ~mask;
       }
-      mask >>= 1;
-      if (mask == 0) mask = 0x80;
     }
   }
 
-public:
-  bool retrieveBitmap(const RLEBitmap &fromBitmap, Bitmap &toBitmap, const Pos atOffset,
-                      const RLEMetrics rleMetrics) {
-    // point on the glyphs' bitmap definition
-    memoryPtr = (MemoryPtr) fromBitmap.pixels.data();
-    memoryEnd = memoryPtr + fromBitmap.length;
-    MemoryPtr toRowPtr;
+  inline void fillSpanEightBits(MemoryPtr toLine, uint32_t fromCol, uint32_t size) const {
+    memset(toLine + fromCol, 0xFF, size);
+  }
 
-    if ((atOffset.x < 0) || (atOffset.y < 0) ||
-        ((atOffset.y + fromBitmap.dim.height) > toBitmap.dim.height) ||
-        ((atOffset.x + fromBitmap.dim.width) > toBitmap.dim.width))
-      return false;
+  // Sets size bits starting at bit fromCol: masked writes for the partial bytes at
+  // both ends, whole bytes in between.
+  void fillSpanOneBit(MemoryPtr toLine, uint32_t fromCol, uint32_t size) const {
+    uint32_t first    = fromCol >> 3;
+    uint32_t last     = (fromCol + size - 1) >> 3;
+    uint8_t  headMask = 0xFF >> (fromCol & 7);
+    uint8_t  tailMask = 0xFF << (7 - ((fromCol + size - 1) & 7));
+    if (first == last) {
+      toLine[first] |= headMask & tailMask;
+    } else {
+      toLine[first] |= headMask;
+      memset(toLine + first + 1, 0xFF, last - first - 1);
+      toLine[last] |= tailMask;
+    }
+  }
 
-    if (resolution == PixelResolution::ONE_BIT) {
+  // Non-compressed bitmap (dynF == 14)
+  bool retrieveRawBitmap(const RLEBitmap &fromBitmap, BasicBitmap<RESOLUTION> &toBitmap,
+                         const Pos atOffset) {
+    MemoryPtr toRowPtr;
+    uint32_t  count = 8;
+    uint8_t   data;
+
+    if constexpr (RESOLUTION == PixelResolution::ONE_BIT) {
       uint32_t toRowSize = (toBitmap.dim.width + 7) >> 3;
       toRowPtr           = toBitmap.pixels.data() + (atOffset.y * toRowSize);
 
-      if (rleMetrics.dynF == 14) { // is a non-compressed RLE?
-        uint32_t count = 8;
-        uint8_t  data;
-
-        for (uint32_t fromRow = 0; fromRow < fromBitmap.dim.height;
-             fromRow++, toRowPtr += toRowSize) {
-          for (uint32_t toCol = atOffset.x; toCol < fromBitmap.dim.width + atOffset.x; toCol++) {
-            if (count >= 8) {
-              if (!getnext8(data)) {
-                std::cerr << "Not enough bitmap data!" << std::endl;
-                return false;
-              }
-              // std::cout << std::hex << +data << ' ';
-              count = 0;
+      for (uint32_t fromRow = 0; fromRow < fromBitmap.dim.height;
+           fromRow++, toRowPtr += toRowSize) {
+        for (uint32_t toCol = atOffset.x; toCol < fromBitmap.dim.width + atOffset.x; toCol++) {
+          if (count >= 8) {
+            if (!getnext8(data)) {
+              std::cerr << "Not enough bitmap data!" << std::endl;
+              return false;
             }
-            if (data & (0x80U >> count)) toRowPtr[toCol >> 3] |= (0x80U >> (toCol & 7));
-            count++;
+            // std::cout << std::hex << +data << ' ';
+            count = 0;
           }
+          if (data & (0x80U >> count)) toRowPtr[toCol >> 3] |= (0x80U >> (toCol & 7));
+          count++;
         }
-        // std::cout << std::endl;
-      } else {
-        uint32_t count = 0;
-
-        repeatCount   = 0;
-        nybbleFlipper = 0xf0U;
-
-        bool black = !(rleMetrics.firstIsBlack == 1);
-
-        for (uint32_t fromRow = 0; fromRow < fromBitmap.dim.height;
-             fromRow++, toRowPtr += toRowSize) {
-          for (uint32_t toCol = atOffset.x; toCol < fromBitmap.dim.width + atOffset.x; toCol++) {
-            if (count == 0) {
-              if (!getPackedNumber(count, rleMetrics)) { return false; }
-              black = !black;
-              // if (black) {
-              //   std::cout << count << ' ';
-              // }
-              // else {
-              //   std::cout << '(' << count << ')' << ' ';
-              // }
-            }
-            if (black) toRowPtr[toCol >> 3] |= (0x80U >> (toCol & 0x07));
-            count--;
-          }
-
-          // if (repeatCount != 0) std::cout << "Repeat count: " << repeatCount
-          // << std::endl;
-          while ((fromRow < fromBitmap.dim.height) && (repeatCount-- > 0)) {
-            copyOneRowOneBit(toRowPtr, toRowPtr + toRowSize, atOffset.x, fromBitmap.dim.width);
-            fromRow++;
-            toRowPtr += toRowSize;
-          }
-
-          repeatCount = 0;
-        }
-        // std::cout << std::endl;
       }
+      // std::cout << std::endl;
     } else {
       uint32_t toRowSize = toBitmap.dim.width;
       toRowPtr           = toBitmap.pixels.data() + (atOffset.y * toRowSize);
 
-      repeatCount   = 0;
-      nybbleFlipper = 0xf0U;
-
-      if (rleMetrics.dynF == 14) { // is a bitmap?
-        uint32_t count = 8;
-        uint8_t  data;
-
-        for (uint32_t fromRow = 0; fromRow < (fromBitmap.dim.height);
-             fromRow++, toRowPtr += toRowSize) {
-          for (uint32_t toCol = atOffset.x; toCol < (fromBitmap.dim.width + atOffset.x); toCol++) {
-            if (count >= 8) {
-              if (!getnext8(data)) {
-                std::cerr << "Not enough bitmap data!" << std::endl;
-                return false;
-              }
-              // std::cout << std::hex << +data << ' ';
-              count = 0;
+      for (uint32_t fromRow = 0; fromRow < (fromBitmap.dim.height);
+           fromRow++, toRowPtr += toRowSize) {
+        for (uint32_t toCol = atOffset.x; toCol < (fromBitmap.dim.width + atOffset.x); toCol++) {
+          if (count >= 8) {
+            if (!getnext8(data)) {
+              std::cerr << "Not enough bitmap data!" << std::endl;
+              return false;
             }
-            toRowPtr[toCol] = (data & (0x80U >> count)) ? 0xFF : 0;
-            count++;
+            // std::cout << std::hex << +data << ' ';
+            count = 0;
           }
+          toRowPtr[toCol] = (data & (0x80U >> count)) ? 0xFF : 0;
+          count++;
         }
-        // std::cout << std::endl;
-      } else {
-        uint32_t count = 0;
-
-        repeatCount   = 0;
-        nybbleFlipper = 0xf0U;
-
-        bool black = !(rleMetrics.firstIsBlack == 1);
-
-        for (uint32_t fromRow = 0; fromRow < (fromBitmap.dim.height);
-             fromRow++, toRowPtr += toRowSize) {
-          for (uint32_t toCol = atOffset.x; toCol < (fromBitmap.dim.width + atOffset.x); toCol++) {
-            if (count == 0) {
-              if (!getPackedNumber(count, rleMetrics)) { return false; }
-              black = !black;
-              // if (black) {
-              //   std::cout << count << ' ';
-              // }
-              // else {
-              //   std::cout << '(' << count << ')' << ' ';
-              // }
-            }
-            if (black) toRowPtr[toCol] = 0xFF;
-            count--;
-          }
+      }
+      // std::cout << std::endl;
+    }
+    return true;
+  }
 
-          // if (repeatCount != 0) std::cout << "Repeat count: " << repeatCount
-          // << std::endl;
-          while ((fromRow < toBitmap.dim.height) && (repeatCount-- > 0)) {
-            copyOneRowEightBits(toRowPtr, toRowPtr + toRowSize, atOffset.x, fromBitmap.dim.width);
-            fromRow++;
-            toRowPtr += toRowSize;
-          }
+  // Run length encoded bitmap, specialized for each dynF value (0..13).
+  //
+  // Once a run length is known, the whole span of pixels is set at once. When the
+  // destination rows are contiguous in memory (same width as the glyph, no offset and,
+  // for one bit pixels, rows made of whole bytes), a run that crosses row boundaries
+  // is set in a single fill, unless a repeat count is pending for the current row.
+  template <uint8_t DYN_F>
+  bool retrieveRLEBitmap(const RLEBitmap &fromBitmap, BasicBitmap<RESOLUTION> &toBitmap,
+                         const Pos atOffset, bool firstIsBlack) {
+    const uint32_t width  = fromBitmap.dim.width;
+    const uint32_t height = fromBitmap.dim.height;
+
+    if ((width == 0) || (height == 0)) return true;
+
+    uint32_t toRowSize;
+    bool     contiguous;
+
+    if constexpr (RESOLUTION == PixelResolution::ONE_BIT) {
+      toRowSize  = (toBitmap.dim.width + 7) >> 3;
+      contiguous = (atOffset.x == 0) && (toBitmap.dim.width == width) && ((width & 7) == 0);
+    } else {
+      toRowSize  = toBitmap.dim.width;
+      contiguous = (atOffset.x == 0) && (toBitmap.dim.width == width);
+    }
+
+    MemoryPtr toRowPtr = toBitmap.pixels.data() + (atOffset.y * toRowSize);
+    uint32_t  row = 0, col = 0, count = 0;
+
+    repeatCount   = 0;
+    pendingRun    = 0;
+    nybbleFlipper = 0xf0U;
 
-          repeatCount = 0;
+    bool black = !firstIsBlack;
+
+    while (row < height) {
+      if (count == 0) {
+        if (!getPackedNumber<DYN_F>(count)) { return false; }
+        black = !black;
+      }
+
+      uint32_t span = width - col;
+      if (contiguous && (repeatCount == 0)) span += (height - row - 1) * width;
+      if (span > count) span = count;
+
+      if (black) {
+        if constexpr (RESOLUTION == PixelResolution::ONE_BIT) {
+          fillSpanOneBit(toRowPtr, atOffset.x + col, span);
+        } else {
+          fillSpanEightBits(toRowPtr, atOffset.x + col, span);
         }
-        // std::cout << std::endl;
+      }
+      count -= span;
+      col += span;
+
+      if (col >= width) {
+        uint32_t rows = col / width;
+        col -= rows * width;
+        row += rows - 1;
+        toRowPtr += (rows - 1) * toRowSize;
+
+        while ((repeatCount > 0) && ((row + 1) < height)) {
+          if constexpr (RESOLUTION == PixelResolution::ONE_BIT) {
+            copyOneRowOneBit(toRowPtr, toRowPtr + toRowSize, atOffset.x, width);
+          } else {
+            copyOneRowEightBits(toRowPtr, toRowPtr + toRowSize, atOffset.x, width);
+          }
+          row++;
+          toRowPtr += toRowSize;
+          repeatCount--;
+        }
+
+        repeatCount = 0;
+        row++;
+        toRowPtr += toRowSize;
       }
     }
     return true;
   }
 
 public:
-  RLEExtractor() {}
+  bool retrieveBitmap(const RLEBitmap &fromBitmap, BasicBitmap<RESOLUTION> &toBitmap,
+                      const Pos atOffset, const RLEMetrics rleMetrics) {
+    // point on the glyphs' bitmap definition
+    memoryPtr = fromBitmap.pixels;
+    memoryEnd = memoryPtr + fromBitmap.length;
+
+    if ((atOffset.x < 0) || (atOffset.y < 0) ||
+        ((atOffset.y + fromBitmap.dim.height) > toBitmap.dim.height) ||
+        ((atOffset.x + fromBitmap.dim.width) > toBitmap.dim.width))
+      return false;
+
+    bool firstIsBlack = rleMetrics.firstIsBlack == 1;
+
+    // clang-format off
+    switch (rleMetrics.dynF) {
+      case  0: return retrieveRLEBitmap< 0>(fromBitmap, toBitmap, atOffset, firstIsBlack);
+      case  1: return retrieveRLEBitmap< 1>(fromBitmap, toBitmap, atOffset, firstIsBlack);
+      case  2: return retrieveRLEBitmap< 2>(fromBitmap, toBitmap, atOffset, firstIsBlack);
+      case  3: return retrieveRLEBitmap< 3>(fromBitmap, toBitmap, atOffset, firstIsBlack);
+      case  4: return retrieveRLEBitmap< 4>(fromBitmap, toBitmap, atOffset, firstIsBlack);
+      case  5: return retrieveRLEBitmap< 5>(fromBitmap, toBitmap, atOffset, firstIsBlack);
+      case  6: return retrieveRLEBitmap< 6>(fromBitmap, toBitmap, atOffset, firstIsBlack);
+      case  7: return retrieveRLEBitmap< 7>(fromBitmap, toBitmap, atOffset, firstIsBlack);
+      case  8: return retrieveRLEBitmap< 8>(fromBitmap, toBitmap, atOffset, firstIsBlack);
+      case  9: return retrieveRLEBitmap< 9>(fromBitmap, toBitmap, atOffset, firstIsBlack);
+      case 10: return retrieveRLEBitmap<10>(fromBitmap, toBitmap, atOffset, firstIsBlack);
+      case 11: return retrieveRLEBitmap<11>(fromBitmap, toBitmap, atOffset, firstIsBlack);
+      case 12: return retrieveRLEBitmap<12>(fromBitmap, toBitmap, atOffset, firstIsBlack);
+      case 13: return retrieveRLEBitmap<13>(fromBitmap, toBitmap, atOffset, firstIsBlack);
+      case 14: return retrieveRawBitmap(fromBitmap, toBitmap, atOffset);
+      default: return false;
+    }
+    // clang-format on
+  }
+
+public:
+  BasicRLEExtractor() {}
 };
+
+typedef BasicRLEExtractor<resolution> RLEExtractor;
@@ -0,0 +1,64 @@
+#include "ReportWriter.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+auto ReportWriter::flush() -> void {
+  if ((stream_ != nullptr) && !buffer_.empty()) {
+    stream_->write(buffer_.data(), buffer_.size());
+    buffer_.clear();
+  }
+}
+
+auto ReportWriter::fill(char ch, size_t count) -> ReportWriter & {
+  if (stream_ == nullptr) {
+    buffer_.append(count, ch);
+    return *this;
+  }
+  while (count > 0) {
+    if (buffer_.size() == BUFFER_SIZE) flush();
+    size_t size = std::min(count, BUFFER_SIZE - buffer_.size());
+    buffer_.append(size, ch);
+    count -= size;
+  }
+  return *this;
+}
+
+auto ReportWriter::putInt(int64_t value) -> ReportWriter & {
+  char     digits[20];
+  int      idx       = sizeof(digits);
+  uint64_t magnitude = (value < 0) ? -uint64_t(value) : uint64_t(value);
+
+  do {
+    digits[--idx] = '0' + (magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude != 0);
+
+  if (value < 0) put('-');
+  return put(&digits[idx], sizeof(digits) - idx);
+}
+
+auto ReportWriter::putHex(uint32_t value, int width) -> ReportWriter & {
+  static constexpr char hexDigits[] = "0123456789abcdef";
+
+  char digits[8];
+  int  idx = sizeof(digits);
+
+  do {
+    digits[--idx] = hexDigits[value & 0x0F];
+    value >>= 4;
+  } while (value != 0);
+
+  int count = sizeof(digits) - idx;
+  if (count < width) fill('0', width - count);
+  return put(&digits[idx], count);
+}
+
+// Whole values, the most frequent ones, are written as integers.
+auto ReportWriter::putFixed(int32_t value) -> ReportWriter & {
+  if ((value & 0x3F) == 0) return putInt(value / 64);
+
+  char buffer[32];
+  int  size = snprintf(buffer, sizeof(buffer), "%g", value / 64.0);
+  return put(buffer, size);
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cinttypes>
+#include <cstring>
+#include <ostream>
+#include <string>
+
+/**
+ * @brief Buffered text output of the reports.
+ *
+ * Written to a stream, the text is formatted in a large buffer that is reused for
+ * the whole report and written to the stream in big blocks, when full and at
+ * destruction time. Written to a string, the text is directly appended to it, as
+ * done by the concurrent tasks of a comparison. Integers are converted without going
+ * through the stream formatting.
+ *
+ */
+class ReportWriter {
+public:
+  static constexpr size_t BUFFER_SIZE = 256 * 1024;
+
+  ReportWriter(std::ostream &stream) : stream_(&stream), buffer_(streamBuffer_) {
+    streamBuffer_.reserve(BUFFER_SIZE);
+  }
+  ReportWriter(std::string &output) : stream_(nullptr), buffer_(output) {}
+  ~ReportWriter() { flush(); }
+
+  ReportWriter(const ReportWriter &)            = delete;
+  ReportWriter &operator=(const ReportWriter &) = delete;
+
+  inline auto put(char ch) -> ReportWriter & {
+    if ((stream_ != nullptr) && (buffer_.size() == BUFFER_SIZE)) flush();
+    buffer_.push_back(ch);
+    return *this;
+  }
+
+  inline auto put(const char *str, size_t size) -> ReportWriter & {
+    if ((stream_ != nullptr) && (size > BUFFER_SIZE - buffer_.size())) {
+      flush();
+      if (size > BUFFER_SIZE) {
+        stream_->write(str, size);
+        return *this;
+      }
+    }
+    buffer_.append(str, size);
+    return *this;
+  }
+
+  inline auto put(const char *str) -> ReportWriter & { return put(str, strlen(str)); }
+  inline auto put(const std::string &str) -> ReportWriter & { return put(str.data(), str.size()); }
+
+  // Writes count times the character ch.
+  auto fill(char ch, size_t count) -> ReportWriter &;
+
+  auto putInt(int64_t value) -> ReportWriter &;
+
+  // Lowercase hexadecimal, left padded with zeros up to width digits.
+  auto putHex(uint32_t value, int width) -> ReportWriter &;
+
+  // FIX16 values (1/64th), formatted as with "%g".
+  auto putFixed(int32_t value) -> ReportWriter &;
+
+  // As U+xxxxx
+  inline auto putCodePoint(char32_t codePoint) -> ReportWriter & {
+    return put("U+", 2).putHex(codePoint, 5);
+  }
+
+  inline auto endl() -> ReportWriter & { return put('\n'); }
+
+  auto flush() -> void;
+
+private:
+  std::ostream *stream_;       // nullptr when writing to a string
+  std::string   streamBuffer_; // Buffer of the stream output
+  std::string  &buffer_;       // streamBuffer_ or the output string
+};
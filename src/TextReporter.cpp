@@ -0,0 +1,120 @@
+#include "TextReporter.hpp"
+
+auto TextReporter::create(std::string &output) const -> DiffReporterPtr {
+  return DiffReporterPtr(new TextReporter(output));
+}
+
+auto TextReporter::append(const std::string &output) -> void { writer_.put(output); }
+
+auto TextReporter::begin(const std::string &path1, const std::string &path2) -> void {
+  writer_.put("IBMF Differences:").endl();
+  writer_.put("< ").put(path1).endl();
+  writer_.put("> ").put(path2).endl();
+}
+
+auto TextReporter::end(int diffCount) -> void {
+  writer_.endl().put("-----").endl();
+  writer_.put("Completed. Number of differences found: ").putInt(diffCount).put('.').endl();
+  writer_.flush();
+}
+
+auto TextReporter::faceCountDiffer(int faceCount1, int faceCount2) -> void {
+  writer_.endl().put("FaceCount differ:").endl();
+  writer_.put("< ").putInt(faceCount1).endl();
+  writer_.put("> ").putInt(faceCount2).endl();
+}
+
+auto TextReporter::faceNotFound(char side, uint8_t pointSize) -> void {
+  writer_.endl().put("----- Face not found:").endl();
+  writer_.put(side).put(" Face with pointSize ").putInt(pointSize).endl();
+}
+
+auto TextReporter::faceHeadersDiffer(const IBMFFontDiff &font1, IBMFFontDiff::FacePtr face1,
+                                     const IBMFFontDiff &font2, IBMFFontDiff::FacePtr face2)
+    -> void {
+  writer_.endl().put("----- Face headers with pointSize ").putInt(face1->header->pointSize);
+  writer_.put(" differ:").endl();
+  font1.showFaceHeader(writer_, '<', face1);
+  font2.showFaceHeader(writer_, '>', face2);
+}
+
+auto TextReporter::glyphMetricsDiffer(char32_t codePoint, const GlyphRef &glyph1,
+                                      const GlyphRef &glyph2) -> void {
+  writer_.endl().put("----- Glyph Metrics differ for codePoint ").putCodePoint(codePoint);
+  writer_.put(" of pointSize ").putInt(glyph1.face.header->pointSize).endl();
+  glyph1.font.showGlyphInfo(writer_, '<', glyph1.glyphCode,
+                            glyph1.face.glyphs[glyph1.glyphCode]);
+  glyph2.font.showGlyphInfo(writer_, '>', glyph2.glyphCode,
+                            glyph2.face.glyphs[glyph2.glyphCode]);
+}
+
+auto TextReporter::glyphPixelsDiffer(char32_t codePoint, const GlyphRef &glyph1,
+                                     const GlyphRef &glyph2) -> void {
+  writer_.endl().put("----- Glyph Pixels differ for codePoint ").putCodePoint(codePoint);
+  writer_.put(" of pointSize ").putInt(glyph1.face.header->pointSize).endl();
+  glyph1.font.showBitmap(writer_, '<', glyph1.face.getBitmap(glyph1.glyphCode));
+  writer_.endl();
+  glyph2.font.showBitmap(writer_, '>', glyph2.face.getBitmap(glyph2.glyphCode));
+}
+
+auto TextReporter::glyphLigKernDiffer(char32_t codePoint, const GlyphRef &glyph1,
+                                      const GlyphRef &glyph2) -> void {
+  writer_.endl().put("----- Glyph Ligature/Kerning differ for codePoint ").putCodePoint(codePoint);
+  writer_.put(" of pointSize ").putInt(glyph1.face.header->pointSize).endl();
+  glyph1.font.showLigKerns(writer_, '<', glyph1.face.glyphsLigKern[glyph1.glyphCode]);
+  writer_.endl();
+  glyph2.font.showLigKerns(writer_, '>', glyph2.face.glyphsLigKern[glyph2.glyphCode]);
+}
+
+auto TextReporter::codePointNotFound(char side, uint8_t pointSize, char32_t codePoint) -> void {
+  writer_.endl().put("----- Face with pointSize ").putInt(pointSize).endl();
+  writer_.put(side).put(" CodePoint not found: ").putCodePoint(codePoint).endl();
+}
+
+auto TextReporter::showLigKernPair(char first, const IBMFFontDiff::LigKernPair *pair) -> void {
+  if (pair == nullptr) {
+    writer_.put(first).put(" None").endl();
+  } else if (pair->ligature) {
+    writer_.put(first).put(" LigCode: ").putCodePoint(pair->value).endl();
+  } else {
+    writer_.put(first).put(" Kern: ").putFixed(pair->value).endl();
+  }
+}
+
+auto TextReporter::ligKernPairDiffer(uint8_t pointSize, const IBMFFontDiff::LigKernPair *pair1,
+                                     const IBMFFontDiff::LigKernPair *pair2) -> void {
+  const IBMFFontDiff::LigKernPair &pair = (pair1 != nullptr) ? *pair1 : *pair2;
+
+  writer_.endl().put("----- ").put(pair.ligature ? "Ligature" : "Kerning").put(" pair ");
+  writer_.putCodePoint(pair.codePoint).put(' ').putCodePoint(pair.nextCodePoint);
+  writer_.put(" of pointSize ").putInt(pointSize);
+  writer_.put((pair1 == nullptr) ? " added:" : (pair2 == nullptr) ? " removed:" : " changed:");
+  writer_.endl();
+  showLigKernPair('<', pair1);
+  showLigKernPair('>', pair2);
+}
+
+auto TextReporter::nextPair() -> void { writer_.endl(); }
+
+auto TextReporter::startSummary() -> void {
+  if (!summaryStarted_) {
+    writer_.endl().put("===== Summary").endl();
+    summaryStarted_ = true;
+  }
+}
+
+auto TextReporter::fontNotPaired(char side, const std::string &path) -> void {
+  startSummary();
+  writer_.put(side).put(" Font not paired: ").put(path).endl();
+}
+
+auto TextReporter::summary(const DiffSummary &summary) -> void {
+  startSummary();
+  writer_.put("Font pairs compared: ").putInt(summary.pairsCompared).endl();
+  writer_.put("Identical pairs: ").putInt(summary.identicalPairs).endl();
+  writer_.put("Pairs with differences: ").putInt(summary.differentPairs).endl();
+  writer_.put("Pairs unable to load: ").putInt(summary.failedPairs).endl();
+  writer_.put("Fonts not paired: ").putInt(summary.unpairedFonts).endl();
+  writer_.put("Total number of differences found: ").putInt(summary.diffCount).put('.').endl();
+  writer_.flush();
+}
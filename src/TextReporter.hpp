@@ -0,0 +1,53 @@
+#pragma once
+
+#include "DiffReporter.hpp"
+#include "ReportWriter.hpp"
+
+/**
+ * @brief Human readable report.
+ *
+ * This is the historical output of the tool, with the metrics, bitmaps and
+ * ligature/kerning steps of both glyphs shown when they differ. The text is
+ * formatted through a ReportWriter.
+ *
+ */
+class TextReporter : public DiffReporter {
+public:
+  TextReporter(std::ostream &stream)
+      : DiffReporter(stream), writer_(stream), summaryStarted_(false) {}
+  TextReporter(std::string &output)
+      : DiffReporter(output), writer_(output), summaryStarted_(false) {}
+
+  auto create(std::string &output) const -> DiffReporterPtr override;
+
+  auto append(const std::string &output) -> void override;
+
+  auto begin(const std::string &path1, const std::string &path2) -> void override;
+  auto end(int diffCount) -> void override;
+
+  auto faceCountDiffer(int faceCount1, int faceCount2) -> void override;
+  auto faceNotFound(char side, uint8_t pointSize) -> void override;
+  auto faceHeadersDiffer(const IBMFFontDiff &font1, IBMFFontDiff::FacePtr face1,
+                         const IBMFFontDiff &font2, IBMFFontDiff::FacePtr face2) -> void override;
+
+  auto glyphMetricsDiffer(char32_t codePoint, const GlyphRef &glyph1, const GlyphRef &glyph2)
+      -> void override;
+  auto glyphPixelsDiffer(char32_t codePoint, const GlyphRef &glyph1, const GlyphRef &glyph2)
+      -> void override;
+  auto glyphLigKernDiffer(char32_t codePoint, const GlyphRef &glyph1, const GlyphRef &glyph2)
+      -> void override;
+  auto codePointNotFound(char side, uint8_t pointSize, char32_t codePoint) -> void override;
+  auto ligKernPairDiffer(uint8_t pointSize, const IBMFFontDiff::LigKernPair *pair1,
+                         const IBMFFontDiff::LigKernPair *pair2) -> void override;
+
+  auto nextPair() -> void override;
+  auto fontNotPaired(char side, const std::string &path) -> void override;
+  auto summary(const DiffSummary &summary) -> void override;
+
+private:
+  ReportWriter writer_;
+  bool         summaryStarted_;
+
+  auto startSummary() -> void;
+  auto showLigKernPair(char first, const IBMFFontDiff::LigKernPair *pair) -> void;
+};
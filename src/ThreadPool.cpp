@@ -0,0 +1,119 @@
+#include "ThreadPool.hpp"
+
+// Pool and worker index of the current thread. The index is -1 for threads that
+// are not part of a pool.
+static thread_local const ThreadPool *currentPool  = nullptr;
+static thread_local int               currentWorker = -1;
+
+ThreadPool::ThreadPool(unsigned threadCount) : queuedCount_(0), nextQueue_(0), stopping_(false) {
+  if (threadCount == 0) threadCount = 1;
+
+  for (unsigned i = 0; i < threadCount; i++) {
+    queues_.emplace_back(new WorkQueue);
+  }
+  for (unsigned i = 0; i < threadCount; i++) {
+    workers_.emplace_back(&ThreadPool::workerLoop, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex_);
+    stopping_ = true;
+  }
+  changed_.notify_all();
+
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+auto ThreadPool::currentIndex() const -> int {
+  return (currentPool == this) ? currentWorker : -1;
+}
+
+auto ThreadPool::run(TaskGroup &group, Task task) -> void {
+  int index = currentIndex();
+  if (index < 0) index = nextQueue_++ % queues_.size();
+
+  group.pending_++;
+  {
+    std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+    queues_[index]->items.push_back(Item{.task = std::move(task), .group = &group});
+  }
+  queuedCount_++;
+
+  { std::lock_guard<std::mutex> lock(sleepMutex_); }
+  changed_.notify_one();
+}
+
+auto ThreadPool::wait(TaskGroup &group) -> void {
+  int  index = currentIndex();
+  Item item;
+
+  while (group.pending_ > 0) {
+    if (popTask(index, item)) {
+      execute(item);
+    } else {
+      std::unique_lock<std::mutex> lock(sleepMutex_);
+      changed_.wait(lock, [&] { return (group.pending_ == 0) || (queuedCount_ > 0); });
+    }
+  }
+}
+
+// Own queue first, newest task first. Then steal the oldest task of the other queues.
+auto ThreadPool::popTask(int index, Item &item) -> bool {
+  int count = queues_.size();
+
+  if (index >= 0) {
+    WorkQueue                  &queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.items.empty()) {
+      item = std::move(queue.items.back());
+      queue.items.pop_back();
+      queuedCount_--;
+      return true;
+    }
+  }
+
+  int start = (index >= 0) ? index + 1 : 0;
+  for (int i = 0; i < count; i++) {
+    int victim = (start + i) % count;
+    if (victim == index) continue;
+    WorkQueue                  &queue = *queues_[victim];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.items.empty()) {
+      item = std::move(queue.items.front());
+      queue.items.pop_front();
+      queuedCount_--;
+      return true;
+    }
+  }
+  return false;
+}
+
+auto ThreadPool::execute(Item &item) -> void {
+  item.task();
+  item.task = nullptr;
+
+  if (--item.group->pending_ == 0) {
+    { std::lock_guard<std::mutex> lock(sleepMutex_); }
+    changed_.notify_all();
+  }
+}
+
+auto ThreadPool::workerLoop(int index) -> void {
+  currentPool   = this;
+  currentWorker = index;
+
+  Item item;
+  while (true) {
+    if (popTask(index, item)) {
+      execute(item);
+    } else {
+      std::unique_lock<std::mutex> lock(sleepMutex_);
+      changed_.wait(lock, [&] { return stopping_ || (queuedCount_ > 0); });
+      if (stopping_ && (queuedCount_ == 0)) return;
+    }
+  }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Work stealing thread pool.
+ *
+ * Each worker owns a queue of tasks. A worker takes its next task from the back
+ * of its own queue (last submitted first) and, when empty, steals one from the
+ * front of the other queues. Tasks submitted from outside of the pool are
+ * dispatched to the worker queues in turn.
+ *
+ * Tasks are submitted as part of a TaskGroup. A thread waiting for a group to
+ * complete runs pending tasks while waiting, so that tasks can themselves submit
+ * and wait for sub-tasks without dead-locking the pool.
+ *
+ */
+class ThreadPool {
+public:
+  typedef std::function<void()> Task;
+
+  class TaskGroup {
+  public:
+    TaskGroup() : pending_(0) {}
+
+  private:
+    friend class ThreadPool;
+    std::atomic<int> pending_;
+  };
+
+  ThreadPool(unsigned threadCount = std::thread::hardware_concurrency());
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &)            = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  auto run(TaskGroup &group, Task task) -> void;
+  auto wait(TaskGroup &group) -> void;
+
+  inline auto getThreadCount() const -> unsigned { return workers_.size(); }
+
+private:
+  struct Item {
+    Task       task;
+    TaskGroup *group;
+  };
+
+  struct WorkQueue {
+    std::mutex       mutex;
+    std::deque<Item> items;
+  };
+
+  std::vector<std::unique_ptr<WorkQueue>> queues_; // One for each worker
+  std::vector<std::thread>                workers_;
+
+  std::mutex              sleepMutex_;
+  std::condition_variable changed_;
+  std::atomic<int>        queuedCount_;
+  std::atomic<unsigned>   nextQueue_;
+  bool                    stopping_;
+
+  auto workerLoop(int index) -> void;
+  auto popTask(int index, Item &item) -> bool;
+  auto execute(Item &item) -> void;
+  auto currentIndex() const -> int;
+};
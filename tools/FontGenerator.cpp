@@ -0,0 +1,161 @@
+#include "FontGenerator.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include "FontWriter.hpp"
+#include "Random.hpp"
+
+namespace {
+
+// Salts of the random sequences, for the different parts of a font
+constexpr uint64_t GLYPH_SALT    = 1;
+constexpr uint64_t PROGRAM_SALT  = 2;
+constexpr uint64_t LIG_KERN_SALT = 3;
+constexpr uint64_t CHANGE_SALT   = 4;
+
+// A few overlapping rectangles, giving runs of various lengths and repeated rows.
+auto drawGlyph(Random &random, int minSize, int size, FontModel::Glyph &glyph) -> void {
+  glyph.width  = random.range(std::max(minSize, size / 3), size);
+  glyph.height = random.range(std::max(minSize, size / 2), size);
+  glyph.pixels.assign(glyph.width * glyph.height, 0);
+
+  int rectCount = random.range(1, 3);
+  for (int rect = 0; rect < rectCount; rect++) {
+    int left   = random.below(glyph.width);
+    int right  = random.range(left, glyph.width - 1);
+    int top    = random.below(glyph.height);
+    int bottom = random.range(top, glyph.height - 1);
+    for (int row = top; row <= bottom; row++) {
+      memset(&glyph.pixels[(row * glyph.width) + left], 1, right - left + 1);
+    }
+  }
+}
+
+} // namespace
+
+auto FontGenerator::checkOptions() const -> bool {
+  const FontGeneratorOptions &opt = options_;
+
+  bool valid = (opt.faceCount >= 1) && (opt.faceCount <= 100) && (opt.glyphCount >= 1) &&
+               (opt.glyphCount <= MAX_GLYPH_COUNT) && (opt.bundleSize >= 0) &&
+               (opt.ligKernDensity >= 0) && (opt.ligKernDensity <= 100) &&
+               (opt.ligKernSteps >= 1) && (opt.minGlyphSize >= 1) &&
+               (opt.minGlyphSize <= opt.maxGlyphSize) && (opt.maxGlyphSize <= 127) &&
+               (opt.changedGlyphs >= 0) && (opt.changedGlyphs <= 100);
+  for (int dynF : opt.dynFs) valid = valid && (dynF >= 0) && (dynF <= 14);
+
+  if (!valid) std::cerr << "Font generator options out of range." << std::endl;
+  return valid;
+}
+
+auto FontGenerator::generate(std::vector<uint8_t> &font) const -> bool {
+  FontModel model;
+  return build(model) && FontWriter(model).write(font);
+}
+
+auto FontGenerator::build(FontModel &model) const -> bool {
+  if (!checkOptions()) return false;
+
+  std::vector<char32_t> codePoints = allocateCodePoints();
+
+  model.format = options_.format;
+  model.faces.clear();
+  for (int faceIdx = 0; faceIdx < options_.faceCount; faceIdx++) {
+    model.faces.push_back(buildFace(faceIdx, codePoints));
+  }
+  return true;
+}
+
+// Bundles of bundleSize codePoints, separated by an unused codePoint. A bundle ends
+// at a plane boundary.
+auto FontGenerator::allocateCodePoints() const -> std::vector<char32_t> {
+  if (options_.format == FontFormat::LATIN) {
+    return std::vector<char32_t>(fontFormat0CodePoints.begin(), fontFormat0CodePoints.end());
+  }
+
+  std::vector<char32_t> codePoints;
+  char32_t              codePoint  = 0x21;
+  int                   bundleSize = 0;
+
+  for (int glyphCode = 0; glyphCode < options_.glyphCount; glyphCode++) {
+    if ((options_.bundleSize > 0) && (bundleSize == options_.bundleSize)) {
+      codePoint += 1;
+      bundleSize = 0;
+    }
+    if ((codePoint & 0xFFFF) == 0) bundleSize = 0;
+    codePoints.push_back(codePoint++);
+    bundleSize += 1;
+  }
+  return codePoints;
+}
+
+auto FontGenerator::buildFace(int faceIdx, const std::vector<char32_t> &codePoints) const
+    -> FontModel::Face {
+  const FontGeneratorOptions &opt = options_;
+  FontModel::Face             face;
+
+  int pointSize    = 8 + (2 * faceIdx);
+  int maxPointSize = 8 + (2 * (opt.faceCount - 1));
+  int size         = std::max(opt.minGlyphSize, (opt.maxGlyphSize * pointSize) / maxPointSize);
+  int glyphCount   = codePoints.size();
+
+  face.header = FaceHeader{.pointSize        = uint8_t(pointSize),
+                           .lineHeight       = uint8_t(size + (size / 4)),
+                           .dpi              = 150,
+                           .xHeight          = FIX16((size / 2) << 6),
+                           .emSize           = FIX16(size << 6),
+                           .slantCorrection  = 0,
+                           .descenderHeight  = uint8_t(size / 4),
+                           .spaceSize        = uint8_t((size / 3) + 1),
+                           .glyphCount       = 0,
+                           .ligKernStepCount = 0,
+                           .pixelsPoolSize   = 0};
+
+  // The lig/kern programs, shared by the glyphs. Their steps must be reachable by the
+  // 14 bits goTo displacements.
+  int programCount = 0;
+  if (opt.ligKernDensity > 0) {
+    programCount = std::min(254, std::max(1, (glyphCount * opt.ligKernDensity) / 100));
+  }
+  int stepCount = std::min(opt.ligKernSteps, (16383 - programCount) / std::max(1, programCount));
+
+  std::vector<std::vector<FontModel::LigKern>> programs(programCount);
+  for (int program = 0; program < programCount; program++) {
+    Random random(opt.seed, (uint64_t(faceIdx) << 16) | program, PROGRAM_SALT);
+    for (int idx = 0; idx < stepCount; idx++) {
+      FontModel::LigKern ligKern;
+      ligKern.nextCodePoint = codePoints[random.below(glyphCount)];
+      ligKern.isAKern       = random.below(8) != 0;
+      ligKern.value         = ligKern.isAKern ? random.range(-128, 64)
+                                              : int32_t(codePoints[random.below(glyphCount)]);
+      programs[program].push_back(ligKern);
+    }
+  }
+
+  for (int glyphCode = 0; glyphCode < glyphCount; glyphCode++) {
+    bool     changed = Random(opt.seed, glyphCode, CHANGE_SALT).percent(opt.changedGlyphs);
+    uint64_t seed    = changed ? (opt.seed ^ (uint64_t(opt.variant) << 32)) : opt.seed;
+
+    Random           random(seed, (uint64_t(faceIdx) << 16) | glyphCode, GLYPH_SALT);
+    FontModel::Glyph glyph{};
+
+    drawGlyph(random, opt.minGlyphSize, size, glyph);
+    glyph.codePoint        = codePoints[glyphCode];
+    glyph.mainCodePoint    = codePoints[glyphCode];
+    glyph.horizontalOffset = -random.range(0, 1);
+    glyph.verticalOffset   = glyph.height - random.range(0, size / 4);
+    glyph.advance          = (glyph.width + random.range(0, 2)) << 6;
+    glyph.dynF             = opt.dynFs.empty() ? -1 : opt.dynFs[random.below(opt.dynFs.size())];
+
+    Random ligKernRandom(opt.seed, glyphCode, LIG_KERN_SALT);
+    if ((programCount > 0) && ligKernRandom.percent(opt.ligKernDensity)) {
+      glyph.ligKerns = programs[ligKernRandom.below(programCount)];
+    }
+
+    face.glyphs.push_back(std::move(glyph));
+  }
+
+  return face;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cinttypes>
+#include <vector>
+
+#include "FontModel.hpp"
+
+struct FontGeneratorOptions {
+  FontFormat       format         = FontFormat::UTF32;
+  int              faceCount      = 3;    // Faces, of point sizes 8, 10, 12, ...
+  int              glyphCount     = 1000; // Glyphs of each face, but for the LATIN format
+  int              bundleSize     = 64;   // CodePoints of a bundle, 0 for one bundle per plane
+  int              ligKernDensity = 20;   // Percentage of glyphs with a lig/kern program
+  int              ligKernSteps   = 8;    // Steps of each lig/kern program
+  int              minGlyphSize   = 1;    // Bitmap widths and heights range, in pixels,
+  int              maxGlyphSize   = 24;   // for the largest face
+  std::vector<int> dynFs;                 // dynF drawn for each glyph, none for the smallest
+  int              changedGlyphs = 0;     // Percentage of glyphs whose content depends on variant
+  uint32_t         seed          = 1;     // Content of the glyphs
+  uint32_t         variant       = 0;     // Content of the changed glyphs
+};
+
+/**
+ * @brief Generator of synthetic IBMF fonts.
+ *
+ * For the UTF32 and BACKUP formats, the glyphs codePoints are allocated from
+ * U+00021, in bundles separated by one unused codePoint. The LATIN format fonts have
+ * the fontFormat0CodePoints glyphs. The bitmaps are made of a few overlapping
+ * rectangles. Up to 254 lig/kern programs, as allowed by the glyphs 8 bits
+ * ligKernPgmIndex, are shared by the glyphs with ligatures and kerning.
+ *
+ * The content only depends on the options: the same options always give the same
+ * font. Two fonts generated with the same options but variant differ in about
+ * changedGlyphs percent of their glyphs (bitmap and metrics), to compare them.
+ *
+ */
+class FontGenerator {
+public:
+  static constexpr int MAX_GLYPH_COUNT = 32765; // Limit of the lig/kern steps glyph codes
+
+  FontGenerator(const FontGeneratorOptions &options) : options_(options) {}
+
+  // Both return false, with a message on std::cerr, if the options are out of range.
+  auto build(FontModel &model) const -> bool;
+  auto generate(std::vector<uint8_t> &font) const -> bool;
+
+private:
+  FontGeneratorOptions options_;
+
+  auto checkOptions() const -> bool;
+  auto allocateCodePoints() const -> std::vector<char32_t>;
+  auto buildFace(int faceIdx, const std::vector<char32_t> &codePoints) const -> FontModel::Face;
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cinttypes>
+#include <optional>
+#include <vector>
+
+#include "IBMFDefs.hpp"
+
+using namespace IBMFDefs;
+
+/**
+ * @brief Editable content of an IBMF font.
+ *
+ * The font tools work on this model: FontGenerator creates it, FontReader retrieves
+ * it from an IBMF file, FontMutator changes it and FontWriter converts it to any IBMF
+ * format. The glyphs are identified by their codePoint, including in the ligature and
+ * kerning steps, such that glyphs can be added or removed without renumbering them.
+ *
+ */
+struct FontModel {
+  struct LigKern {
+    char32_t nextCodePoint;
+    bool     isAKern;
+    int32_t  value; // Kerning in FIX16, or replacement codePoint for a ligature
+  };
+
+  // RLE packet of a glyph read from a font, with the bitmap it decodes to. FontWriter
+  // writes it back as is while the glyph bitmap and dynF are unchanged.
+  struct Packet {
+    uint8_t              width, height;
+    uint8_t              dynF;
+    bool                 firstIsBlack;
+    std::vector<uint8_t> pixels;
+    std::vector<uint8_t> data;
+  };
+
+  struct Glyph {
+    char32_t              codePoint;
+    char32_t              mainCodePoint; // For the kerning matching algorithm
+    uint8_t               width, height;
+    int8_t                horizontalOffset, verticalOffset;
+    FIX16                 advance;
+    int8_t                dynF; // RLE compression, -1 for the smallest packet
+    uint8_t               beforeAddedOptKern, afterAddedOptKern;
+    std::vector<uint8_t>  pixels; // width * height bytes, 1 for black
+    std::vector<LigKern>  ligKerns;
+    std::optional<Packet> packet; // None for the glyphs to encode
+  };
+
+  // The glyphCount, ligKernStepCount and pixelsPoolSize of the header are set by
+  // FontWriter. For the UTF32 format, the glyphs are sorted by codePoint and every face
+  // has the same codePoints. For the LATIN format, they are the fontFormat0CodePoints.
+  struct Face {
+    FaceHeader         header;
+    std::vector<Glyph> glyphs;
+  };
+
+  FontFormat        format = FontFormat::UTF32;
+  std::vector<Face> faces;
+};
@@ -0,0 +1,164 @@
+#include "FontMutator.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <unordered_set>
+
+#include "Random.hpp"
+
+namespace {
+
+// Salts of the random sequences, for each kind of mutation
+constexpr uint64_t METRICS_SALT  = 11;
+constexpr uint64_t PIXELS_SALT   = 12;
+constexpr uint64_t DYN_F_SALT    = 13;
+constexpr uint64_t LIG_KERN_SALT = 14;
+constexpr uint64_t REMOVED_SALT  = 15;
+constexpr uint64_t ADDED_SALT    = 16;
+constexpr uint64_t CONTENT_SALT  = 17;
+
+// Inverts a rectangle of pixels. An empty bitmap becomes a single black pixel.
+auto invertPixels(Random &random, FontModel::Glyph &glyph) -> void {
+  if (glyph.pixels.empty()) {
+    glyph.width  = 1;
+    glyph.height = 1;
+    glyph.pixels = {1};
+    return;
+  }
+
+  int left   = random.below(glyph.width);
+  int top    = random.below(glyph.height);
+  int right  = std::min(glyph.width - 1, left + random.range(0, glyph.width / 3));
+  int bottom = std::min(glyph.height - 1, top + random.range(0, glyph.height / 3));
+  for (int row = top; row <= bottom; row++) {
+    for (int col = left; col <= right; col++) glyph.pixels[(row * glyph.width) + col] ^= 1;
+  }
+}
+
+// Identifies a lig/kern program from its steps.
+auto programKey(const std::vector<FontModel::LigKern> &ligKerns) -> uint64_t {
+  uint64_t key = 0;
+  for (auto &ligKern : ligKerns) {
+    uint64_t step = (uint64_t(uint32_t(ligKern.value)) << 1) | uint64_t(ligKern.isAKern);
+    key           = Random(key, ligKern.nextCodePoint, step).next();
+  }
+  return key;
+}
+
+} // namespace
+
+auto FontMutator::checkOptions(const FontModel &model) const -> bool {
+  const MutationOptions &opt = options_;
+
+  for (int percentage : {opt.metrics, opt.pixels, opt.dynF, opt.ligKerns, opt.removedGlyphs,
+                         opt.addedGlyphs}) {
+    if ((percentage < 0) || (percentage > 100)) {
+      std::cerr << "Mutation percentages must be in the 0 to 100 range." << std::endl;
+      return false;
+    }
+  }
+  if ((model.format == FontFormat::LATIN) && ((opt.removedGlyphs > 0) || (opt.addedGlyphs > 0))) {
+    std::cerr << "Glyphs cannot be added or removed in a LATIN format font." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+auto FontMutator::mutate(FontModel &model) const -> bool {
+  if (!checkOptions(model)) return false;
+
+  for (size_t faceIdx = 0; faceIdx < model.faces.size(); faceIdx++) {
+    FontModel::Face &face = model.faces[faceIdx];
+
+    if (options_.removedGlyphs > 0) removeGlyphs(face);
+    if (options_.addedGlyphs > 0) addGlyphs(face);
+    for (auto &glyph : face.glyphs) changeGlyph(face, glyph, faceIdx);
+  }
+  return true;
+}
+
+auto FontMutator::removeGlyphs(FontModel::Face &face) const -> void {
+  std::unordered_set<char32_t> removed;
+
+  for (auto &glyph : face.glyphs) {
+    if (Random(options_.seed, glyph.codePoint, REMOVED_SALT).percent(options_.removedGlyphs)) {
+      removed.insert(glyph.codePoint);
+    }
+  }
+
+  face.glyphs.erase(std::remove_if(face.glyphs.begin(), face.glyphs.end(),
+                                   [&removed](const FontModel::Glyph &glyph) {
+                                     return removed.count(glyph.codePoint) > 0;
+                                   }),
+                    face.glyphs.end());
+
+  for (auto &glyph : face.glyphs) {
+    if (removed.count(glyph.mainCodePoint) > 0) glyph.mainCodePoint = glyph.codePoint;
+    glyph.ligKerns.erase(
+        std::remove_if(glyph.ligKerns.begin(), glyph.ligKerns.end(),
+                       [&removed](const FontModel::LigKern &ligKern) {
+                         return (removed.count(ligKern.nextCodePoint) > 0) ||
+                                (!ligKern.isAKern && (removed.count(ligKern.value) > 0));
+                       }),
+        glyph.ligKerns.end());
+  }
+}
+
+// The codePoint following a selected glyph is added if not already in the face. As the
+// glyphs are sorted by codePoint in the UTF32 format, the added glyph directly follows.
+auto FontMutator::addGlyphs(FontModel::Face &face) const -> void {
+  std::unordered_set<char32_t>  codePoints;
+  std::vector<FontModel::Glyph> glyphs;
+
+  for (auto &glyph : face.glyphs) codePoints.insert(glyph.codePoint);
+
+  for (auto &glyph : face.glyphs) {
+    glyphs.push_back(glyph);
+
+    char32_t codePoint = glyph.codePoint + 1;
+    if ((codePoints.count(codePoint) == 0) && (codePoint <= 0x3FFFF) &&
+        Random(options_.seed, glyph.codePoint, ADDED_SALT).percent(options_.addedGlyphs)) {
+      Random           random(options_.seed, codePoint, CONTENT_SALT);
+      FontModel::Glyph added = glyph;
+
+      added.codePoint     = codePoint;
+      added.mainCodePoint = codePoint;
+      added.ligKerns.clear();
+      invertPixels(random, added);
+      glyphs.push_back(std::move(added));
+    }
+  }
+
+  face.glyphs = std::move(glyphs);
+}
+
+auto FontMutator::changeGlyph(FontModel::Face &face, FontModel::Glyph &glyph, int faceIdx) const
+    -> void {
+  const MutationOptions &opt       = options_;
+  char32_t               codePoint = glyph.codePoint;
+  Random                 random(opt.seed, (uint64_t(faceIdx) << 32) | codePoint, CONTENT_SALT);
+
+  if (Random(opt.seed, codePoint, METRICS_SALT).percent(opt.metrics)) {
+    glyph.advance += random.below(2) ? 64 : -64;
+    glyph.verticalOffset += 1;
+  }
+
+  if (Random(opt.seed, codePoint, PIXELS_SALT).percent(opt.pixels)) invertPixels(random, glyph);
+
+  if (Random(opt.seed, codePoint, DYN_F_SALT).percent(opt.dynF)) {
+    glyph.dynF = (glyph.dynF < 0) ? random.range(0, 14) : (glyph.dynF + random.range(1, 14)) % 15;
+  }
+
+  uint64_t program = programKey(glyph.ligKerns);
+  for (size_t idx = 0; idx < glyph.ligKerns.size(); idx++) {
+    FontModel::LigKern &ligKern = glyph.ligKerns[idx];
+    Random              stepRandom(opt.seed, program + idx, LIG_KERN_SALT);
+
+    if (!stepRandom.percent(opt.ligKerns)) continue;
+    if (ligKern.isAKern) {
+      ligKern.value += stepRandom.below(2) ? stepRandom.range(1, 16) : -stepRandom.range(1, 16);
+    } else {
+      ligKern.value = face.glyphs[stepRandom.below(face.glyphs.size())].codePoint;
+    }
+  }
+}
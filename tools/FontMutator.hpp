@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cinttypes>
+
+#include "FontModel.hpp"
+
+struct MutationOptions {
+  uint32_t seed          = 1; // Selection and content of the mutations
+  int      metrics       = 0; // Percentage of glyphs with another advance and vertical offset
+  int      pixels        = 0; // Percentage of glyphs with inverted pixels
+  int      dynF          = 0; // Percentage of glyphs encoded with another dynF, same pixels
+  int      ligKerns      = 0; // Percentage of lig/kern steps with another value
+  int      removedGlyphs = 0; // Percentage of codePoints removed
+  int      addedGlyphs   = 0; // Percentage of codePoints followed by an added codePoint
+};
+
+/**
+ * @brief Controlled changes of a font model.
+ *
+ * The glyphs to change are selected from their codePoint: the same codePoints are
+ * changed in every face. The lig/kern steps to change are selected from the program
+ * they are part of, such that the programs shared by glyphs stay shared. An added
+ * glyph is a copy of the glyph of the previous codePoint, without lig/kern steps and
+ * with some pixels inverted. The lig/kern steps referring to a removed glyph are
+ * removed too. Glyphs cannot be added or removed in the LATIN format.
+ *
+ */
+class FontMutator {
+public:
+  FontMutator(const MutationOptions &options) : options_(options) {}
+
+  // Returns false, with a message on std::cerr, if the options are out of range or
+  // don't apply to the model format.
+  auto mutate(FontModel &model) const -> bool;
+
+private:
+  MutationOptions options_;
+
+  auto checkOptions(const FontModel &model) const -> bool;
+  auto removeGlyphs(FontModel::Face &face) const -> void;
+  auto addGlyphs(FontModel::Face &face) const -> void;
+  auto changeGlyph(FontModel::Face &face, FontModel::Glyph &glyph, int faceIdx) const -> void;
+};
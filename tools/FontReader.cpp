@@ -0,0 +1,133 @@
+#include "FontReader.hpp"
+
+#include <iostream>
+
+#include "IBMFFontDiff.hpp"
+#include "MappedFile.hpp"
+
+namespace {
+
+// The packet is kept with the decompressed pixels, to be written back as is.
+auto readPixels(const IBMFFontDiff::Face &face, GlyphCode glyphCode, const RLEMetrics &metrics,
+                FontModel::Glyph &glyph) -> bool {
+  EightBitsBitmap bitmap;
+  if (!face.retrieveBitmap(glyphCode, bitmap)) return false;
+
+  glyph.pixels.resize(bitmap.pixels.size());
+  for (size_t idx = 0; idx < bitmap.pixels.size(); idx++) {
+    glyph.pixels[idx] = (bitmap.pixels[idx] == BLACK_EIGHT_BITS) ? 1 : 0;
+  }
+
+  const RLEBitmap     &packet = face.compressedBitmaps[glyphCode];
+  std::vector<uint8_t> data(packet.pixels, packet.pixels + packet.length);
+
+  glyph.packet = FontModel::Packet{.width        = glyph.width,
+                                   .height       = glyph.height,
+                                   .dynF         = metrics.dynF,
+                                   .firstIsBlack = metrics.firstIsBlack != 0,
+                                   .pixels       = glyph.pixels,
+                                   .data         = std::move(data)};
+  return true;
+}
+
+} // namespace
+
+auto FontReader::read(const std::string &filename, FontModel &model) -> bool {
+  MappedFilePtr file = MappedFilePtr(new MappedFile(filename.c_str()));
+  if (!file->isMapped()) {
+    std::cerr << "Unable to open file " << filename << std::endl;
+    return false;
+  }
+
+  IBMFFontDiff font(file, false);
+  if (!font.isInitialized()) {
+    std::cerr << "File " << filename << " is not of an appropriate IBMF format." << std::endl;
+    return false;
+  }
+
+  model.format = font.getFontFormat();
+  model.faces.clear();
+
+  for (int faceIdx = 0; faceIdx < font.getPreamble().faceCount; faceIdx++) {
+    IBMFFontDiff::FacePtr face = font.getFace(faceIdx);
+    FontModel::Face       modelFace;
+
+    modelFace.header = *face->header;
+
+    for (GlyphCode glyphCode = 0; glyphCode < face->header->glyphCount; glyphCode++) {
+      FontModel::Glyph glyph;
+      RLEMetrics       metrics;
+
+      if (model.format == FontFormat::BACKUP) {
+        const BackupGlyphInfo        &info    = face->backupGlyphs[glyphCode];
+        const BackupGlyphLigKernView &ligKern = face->backupGlyphsLigKern[glyphCode];
+
+        metrics = info.rleMetrics;
+        glyph   = FontModel::Glyph{.codePoint          = info.codePoint,
+                                   .mainCodePoint      = info.mainCodePoint,
+                                   .width              = info.bitmapWidth,
+                                   .height             = info.bitmapHeight,
+                                   .horizontalOffset   = info.horizontalOffset,
+                                   .verticalOffset     = info.verticalOffset,
+                                   .advance            = info.advance,
+                                   .dynF               = int8_t(info.rleMetrics.dynF),
+                                   .beforeAddedOptKern = info.rleMetrics.beforeAddedOptKern,
+                                   .afterAddedOptKern  = info.rleMetrics.afterAddedOptKern,
+                                   .pixels             = {},
+                                   .ligKerns           = {},
+                                   .packet             = {}};
+        for (auto &lig : ligKern.ligSteps) {
+          glyph.ligKerns.push_back(FontModel::LigKern{.nextCodePoint = lig.nextCodePoint,
+                                                      .isAKern       = false,
+                                                      .value = int32_t(lig.replacementCodePoint)});
+        }
+        for (auto &kern : ligKern.kernSteps) {
+          glyph.ligKerns.push_back(FontModel::LigKern{
+              .nextCodePoint = kern.nextCodePoint, .isAKern = true, .value = kern.kern});
+        }
+      } else {
+        const GlyphInfo        &info     = face->glyphs[glyphCode];
+        const GlyphLigKernView &ligKern  = face->glyphsLigKern[glyphCode];
+        GlyphCode               mainCode = info.mainCode;
+        if (model.format == FontFormat::LATIN) mainCode &= LATIN_GLYPH_CODE_MASK;
+
+        metrics = info.rleMetrics;
+        glyph   = FontModel::Glyph{.codePoint          = font.getUTF32(glyphCode),
+                                   .mainCodePoint      = font.getUTF32(mainCode),
+                                   .width              = info.bitmapWidth,
+                                   .height             = info.bitmapHeight,
+                                   .horizontalOffset   = info.horizontalOffset,
+                                   .verticalOffset     = info.verticalOffset,
+                                   .advance            = info.advance,
+                                   .dynF               = int8_t(info.rleMetrics.dynF),
+                                   .beforeAddedOptKern = info.rleMetrics.beforeAddedOptKern,
+                                   .afterAddedOptKern  = info.rleMetrics.afterAddedOptKern,
+                                   .pixels             = {},
+                                   .ligKerns           = {},
+                                   .packet             = {}};
+        for (auto &lig : ligKern.ligSteps) {
+          glyph.ligKerns.push_back(
+              FontModel::LigKern{.nextCodePoint = font.getUTF32(lig.nextGlyphCode),
+                                 .isAKern       = false,
+                                 .value = int32_t(font.getUTF32(lig.replacementGlyphCode))});
+        }
+        for (auto &kern : ligKern.kernSteps) {
+          glyph.ligKerns.push_back(
+              FontModel::LigKern{.nextCodePoint = font.getUTF32(kern.nextGlyphCode),
+                                 .isAKern       = true,
+                                 .value         = kern.kern});
+        }
+      }
+
+      if (!readPixels(*face, glyphCode, metrics, glyph)) {
+        std::cerr << "File " << filename << ": unable to decompress a glyph bitmap." << std::endl;
+        return false;
+      }
+      modelFace.glyphs.push_back(std::move(glyph));
+    }
+
+    model.faces.push_back(std::move(modelFace));
+  }
+
+  return true;
+}
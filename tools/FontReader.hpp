@@ -0,0 +1,18 @@
+#pragma once
+
+#include <string>
+
+#include "FontModel.hpp"
+
+/**
+ * @brief Retrieval of an IBMF font content, in any format, as a font model.
+ *
+ * The glyph bitmaps are decompressed. Their RLE packet and metrics are kept, such
+ * that the glyphs left unchanged are written back with the same packets.
+ *
+ */
+class FontReader {
+public:
+  // Returns false, with a message on std::cerr, if the font cannot be loaded.
+  static auto read(const std::string &filename, FontModel &model) -> bool;
+};
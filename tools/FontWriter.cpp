@@ -0,0 +1,505 @@
+#include "FontWriter.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <map>
+
+namespace {
+
+constexpr int MAX_UTF32_GLYPH_COUNT = 32765; // Limit of the lig/kern steps glyph codes
+constexpr int MAX_GOTO_DISPLACEMENT = 16383; // goTo displacements are 14 bits
+
+template <typename T> auto append(std::vector<uint8_t> &font, const T &value) -> void {
+  const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&value);
+  font.insert(font.end(), bytes, bytes + sizeof(T));
+}
+
+// Run of pixels of the same colour. A repeat count other than 0 is written before the
+// run length: the row where the run starts is repeated that many times.
+struct Run {
+  uint32_t length;
+  uint32_t repeat;
+};
+
+// PK packed number, for dynF 0 to 13.
+auto packNumber(uint32_t value, int dynF, std::vector<uint8_t> &nybbles) -> void {
+  if (value <= uint32_t(dynF)) {
+    nybbles.push_back(value);
+  } else if (value <= uint32_t(((13 - dynF) << 4) + dynF)) {
+    value -= dynF + 1;
+    nybbles.push_back((value >> 4) + dynF + 1);
+    nybbles.push_back(value & 0x0F);
+  } else {
+    value      = value - ((13 - dynF) << 4) - dynF + 15;
+    int digits = 0;
+    for (uint32_t v = value; v != 0; v >>= 4) digits++;
+    nybbles.insert(nybbles.end(), digits - 1, 0);
+    for (int digit = digits - 1; digit >= 0; digit--) {
+      nybbles.push_back((value >> (digit * 4)) & 0x0F);
+    }
+  }
+}
+
+// Packs the runs, for dynF 0 to 13. A repeat count of 1 is the single nybble 15, larger
+// ones are the nybble 14 followed by the count.
+auto packRuns(const std::vector<Run> &runs, int dynF, std::vector<uint8_t> &packet) -> void {
+  std::vector<uint8_t> nybbles;
+
+  for (auto &run : runs) {
+    if (run.repeat == 1) {
+      nybbles.push_back(15);
+    } else if (run.repeat > 1) {
+      nybbles.push_back(14);
+      packNumber(run.repeat, dynF, nybbles);
+    }
+    packNumber(run.length, dynF, nybbles);
+  }
+  if (nybbles.size() & 1) nybbles.push_back(0);
+
+  packet.clear();
+  for (size_t idx = 0; idx < nybbles.size(); idx += 2) {
+    packet.push_back((nybbles[idx] << 4) | nybbles[idx + 1]);
+  }
+}
+
+// Runs of a bitmap, as in the PK fonts. The rows identical to the one before them are
+// left out of the runs, with a repeat count before the first run starting in the repeated
+// row, other than the first run of the bitmap. Only the rows with a colour change are
+// repeated that way: the others are cheaper as part of a longer run.
+auto bitmapRuns(const FontModel::Glyph &glyph) -> std::vector<Run> {
+  const int        width = glyph.width;
+  std::vector<Run> runs;
+  Run              run{.length = 0, .repeat = 0};
+  uint8_t          color = glyph.pixels[0];
+
+  for (int row = 0; row < glyph.height;) {
+    const uint8_t *pixels = &glyph.pixels[row * width];
+
+    int repeat = 0;
+    while ((row + repeat + 1 < glyph.height) &&
+           (memcmp(pixels, pixels + ((repeat + 1) * width), width) == 0)) {
+      repeat++;
+    }
+
+    bool changes = false;
+    for (int col = 1; !changes && (col < width); col++) changes = pixels[col] != pixels[col - 1];
+    if (!changes) repeat = 0;
+
+    uint32_t pending = repeat;
+    for (int col = 0; col < width; col++) {
+      if (pixels[col] != color) {
+        runs.push_back(run);
+        run     = Run{.length = 0, .repeat = pending};
+        color   = pixels[col];
+        pending = 0;
+      }
+      run.length++;
+    }
+
+    row += 1 + repeat;
+  }
+  runs.push_back(run);
+
+  return runs;
+}
+
+// The packet read from a font, if the glyph bitmap and dynF are still the same.
+auto keptPacket(const FontModel::Glyph &glyph) -> const FontModel::Packet * {
+  const std::optional<FontModel::Packet> &packet = glyph.packet;
+
+  if (packet && (packet->dynF == glyph.dynF) && (packet->width == glyph.width) &&
+      (packet->height == glyph.height) && (packet->pixels == glyph.pixels)) {
+    return &*packet;
+  }
+  return nullptr;
+}
+
+// Non-compressed bitmap (dynF == 14): one bit per pixel, rows not padded.
+auto packRaw(const std::vector<uint8_t> &pixels, std::vector<uint8_t> &packet) -> void {
+  packet.assign((pixels.size() + 7) >> 3, 0);
+  for (size_t idx = 0; idx < pixels.size(); idx++) {
+    if (pixels[idx]) packet[idx >> 3] |= 0x80U >> (idx & 7);
+  }
+}
+
+auto findGlyphCode(const std::vector<std::pair<char32_t, GlyphCode>> &glyphCodes,
+                   char32_t codePoint, GlyphCode &glyphCode) -> bool {
+  auto it = std::lower_bound(glyphCodes.begin(), glyphCodes.end(),
+                             std::make_pair(codePoint, GlyphCode(0)));
+  if ((it == glyphCodes.end()) || (it->first != codePoint)) return false;
+  glyphCode = it->second;
+  return true;
+}
+
+} // namespace
+
+auto FontWriter::encodeBitmap(const FontModel::Glyph &glyph, int dynF,
+                              std::vector<uint8_t> &packet) -> int {
+  if (glyph.pixels.empty()) {
+    packet.clear();
+    return (dynF < 0) ? 14 : dynF;
+  }
+
+  if (dynF == 14) {
+    packRaw(glyph.pixels, packet);
+    return dynF;
+  }
+
+  std::vector<Run> runs = bitmapRuns(glyph);
+
+  if (dynF >= 0) {
+    packRuns(runs, dynF, packet);
+  } else {
+    std::vector<uint8_t> candidate;
+    packRaw(glyph.pixels, packet);
+    dynF = 14;
+    for (int f = 0; f < 14; f++) {
+      packRuns(runs, f, candidate);
+      if (candidate.size() < packet.size()) {
+        packet.swap(candidate);
+        dynF = f;
+      }
+    }
+  }
+  return dynF;
+}
+
+auto FontWriter::save(const std::string &filename) const -> bool {
+  std::vector<uint8_t> font;
+  if (!write(font)) return false;
+
+  FILE *file = fopen(filename.c_str(), "wb");
+  if (file == nullptr) {
+    std::cerr << "Unable to create file " << filename << std::endl;
+    return false;
+  }
+  bool written = fwrite(font.data(), 1, font.size(), file) == font.size();
+  if ((fclose(file) != 0) || !written) {
+    std::cerr << "Unable to write file " << filename << std::endl;
+    return false;
+  }
+  return true;
+}
+
+auto FontWriter::write(std::vector<uint8_t> &font) const -> bool {
+  if (!checkFaces()) return false;
+
+  font.clear();
+
+  Preamble preamble;
+  memcpy(preamble.marker, "IBMF", 4);
+  preamble.faceCount       = model_.faces.size();
+  preamble.bits.version    = 4;
+  preamble.bits.fontFormat = model_.format;
+  append(font, preamble);
+
+  // Point sizes, padded to 32 bits, then the faces offsets, set once known
+  for (auto &face : model_.faces) font.push_back(face.header.pointSize);
+  font.resize((font.size() + 3) & ~3, 0);
+  size_t offsetsIdx = font.size();
+  font.resize(font.size() + (sizeof(uint32_t) * model_.faces.size()), 0);
+
+  if (model_.format == FontFormat::UTF32) appendPlanes(font);
+
+  for (size_t faceIdx = 0; faceIdx < model_.faces.size(); faceIdx++) {
+    uint32_t offset = font.size();
+    memcpy(&font[offsetsIdx + (sizeof(uint32_t) * faceIdx)], &offset, sizeof(uint32_t));
+    if (!appendFace(font, model_.faces[faceIdx])) return false;
+  }
+
+  return true;
+}
+
+auto FontWriter::checkFaces() const -> bool {
+  const char *error = nullptr;
+
+  if (model_.faces.empty() || (model_.faces.size() > 255)) error = "1 to 255 faces expected";
+
+  for (auto &face : model_.faces) {
+    if (error != nullptr) break;
+
+    const std::vector<FontModel::Glyph> &glyphs = face.glyphs;
+
+    if (glyphs.size() > 0xFFFF) error = "too many glyphs in a face";
+
+    for (auto &glyph : glyphs) {
+      if (glyph.pixels.size() != size_t(glyph.width * glyph.height)) {
+        error = "glyph pixels not matching the glyph dimensions";
+      } else if ((glyph.dynF < -1) || (glyph.dynF > 14)) {
+        error = "glyph dynF out of range";
+      }
+    }
+
+    if (model_.format == FontFormat::UTF32) {
+      if (glyphs.size() > MAX_UTF32_GLYPH_COUNT) error = "too many glyphs in a UTF32 face";
+      for (size_t idx = 0; idx < glyphs.size(); idx++) {
+        if ((idx > 0) && (glyphs[idx].codePoint <= glyphs[idx - 1].codePoint)) {
+          error = "UTF32 glyphs not sorted by codePoint";
+        } else if (glyphs[idx].codePoint > 0x3FFFF) {
+          error = "UTF32 codePoint beyond plane 3";
+        }
+      }
+      const std::vector<FontModel::Glyph> &first = model_.faces[0].glyphs;
+      if (!std::equal(glyphs.begin(), glyphs.end(), first.begin(), first.end(),
+                      [](const FontModel::Glyph &g1, const FontModel::Glyph &g2) {
+                        return g1.codePoint == g2.codePoint;
+                      })) {
+        error = "UTF32 faces with different codePoints";
+      }
+    } else if (model_.format == FontFormat::LATIN) {
+      if ((glyphs.size() != fontFormat0CodePoints.size()) ||
+          !std::equal(glyphs.begin(), glyphs.end(), fontFormat0CodePoints.begin(),
+                      [](const FontModel::Glyph &glyph, char16_t codePoint) {
+                        return glyph.codePoint == codePoint;
+                      })) {
+        error = "LATIN faces must have the fontFormat0CodePoints glyphs";
+      }
+    }
+  }
+
+  if (error != nullptr) {
+    std::cerr << "Unable to write the font: " << error << "." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+// The codePoints of consecutive glyphs are in the same bundle.
+auto FontWriter::appendPlanes(std::vector<uint8_t> &font) const -> void {
+  const std::vector<FontModel::Glyph> &glyphs = model_.faces[0].glyphs;
+  std::vector<CodePointBundle>         bundles;
+  Planes                               planes;
+  int                                  plane = -1;
+
+  for (size_t glyphCode = 0; glyphCode < glyphs.size(); glyphCode++) {
+    char32_t codePoint = glyphs[glyphCode].codePoint;
+
+    while (int(codePoint >> 16) > plane) {
+      plane += 1;
+      planes[plane] = Plane{.codePointBundlesIdx = uint16_t(bundles.size()),
+                            .entriesCount        = 0,
+                            .firstGlyphCode      = GlyphCode(glyphCode)};
+    }
+
+    if ((planes[plane].entriesCount > 0) &&
+        (char16_t(codePoint) == char16_t(bundles.back().lastCodePoint + 1))) {
+      bundles.back().lastCodePoint = char16_t(codePoint);
+    } else {
+      bundles.push_back(CodePointBundle{.firstCodePoint = char16_t(codePoint),
+                                        .lastCodePoint  = char16_t(codePoint)});
+      planes[plane].entriesCount += 1;
+    }
+  }
+
+  while (plane < 3) {
+    plane += 1;
+    planes[plane] = Plane{.codePointBundlesIdx = uint16_t(bundles.size()),
+                          .entriesCount        = 0,
+                          .firstGlyphCode      = GlyphCode(glyphs.size())};
+  }
+
+  append(font, planes);
+  for (auto &bundle : bundles) append(font, bundle);
+}
+
+auto FontWriter::appendFace(std::vector<uint8_t> &font, const FontModel::Face &face) const
+    -> bool {
+  const std::vector<FontModel::Glyph> &glyphs = face.glyphs;
+  bool                                 backup = model_.format == FontFormat::BACKUP;
+
+  GlyphCodes glyphCodes;
+  if (!backup) {
+    for (size_t glyphCode = 0; glyphCode < glyphs.size(); glyphCode++) {
+      glyphCodes.push_back(std::make_pair(glyphs[glyphCode].codePoint, GlyphCode(glyphCode)));
+    }
+    std::stable_sort(glyphCodes.begin(), glyphCodes.end(),
+                     [](auto &a, auto &b) { return a.first < b.first; });
+  }
+
+  std::vector<uint8_t> ligKernSteps;
+  std::vector<uint8_t> pgmIndexes;
+  if (!backup && !appendLigKernSteps(ligKernSteps, face, glyphCodes, pgmIndexes)) return false;
+
+  std::vector<PixelPoolIndex> poolIndexes;
+  std::vector<uint8_t>        glyphsInfo;
+  std::vector<uint8_t>        pixelsPool;
+  std::vector<uint8_t>        packet;
+  FaceHeader                  header = face.header;
+
+  header.glyphCount = glyphs.size();
+
+  for (size_t glyphCode = 0; glyphCode < glyphs.size(); glyphCode++) {
+    const FontModel::Glyph &glyph = glyphs[glyphCode];
+
+    RLEMetrics               metrics{};
+    const FontModel::Packet *kept = keptPacket(glyph);
+
+    if (kept != nullptr) {
+      packet               = kept->data;
+      metrics.dynF         = kept->dynF;
+      metrics.firstIsBlack = kept->firstIsBlack;
+    } else {
+      metrics.dynF         = encodeBitmap(glyph, glyph.dynF, packet);
+      metrics.firstIsBlack = glyph.pixels.empty() ? 0 : glyph.pixels[0];
+    }
+    metrics.beforeAddedOptKern = glyph.beforeAddedOptKern;
+    metrics.afterAddedOptKern  = glyph.afterAddedOptKern;
+
+    if (packet.size() > 0xFFFF) {
+      std::cerr << "Unable to write the font: glyph packet too large." << std::endl;
+      return false;
+    }
+
+    poolIndexes.push_back(pixelsPool.size());
+
+    if (backup) {
+      int ligCount = std::count_if(glyph.ligKerns.begin(), glyph.ligKerns.end(),
+                                   [](auto &ligKern) { return !ligKern.isAKern; });
+      append(glyphsInfo,
+             BackupGlyphInfo{.bitmapWidth      = glyph.width,
+                             .bitmapHeight     = glyph.height,
+                             .horizontalOffset = glyph.horizontalOffset,
+                             .verticalOffset   = glyph.verticalOffset,
+                             .packetLength     = uint16_t(packet.size()),
+                             .advance          = glyph.advance,
+                             .rleMetrics       = metrics,
+                             .ligCount         = int16_t(ligCount),
+                             .kernCount        = int16_t(glyph.ligKerns.size() - ligCount),
+                             .mainCodePoint    = glyph.mainCodePoint,
+                             .codePoint        = glyph.codePoint});
+    } else {
+      GlyphCode mainCode;
+      if (!findGlyphCode(glyphCodes, glyph.mainCodePoint, mainCode)) mainCode = glyphCode;
+      append(glyphsInfo, GlyphInfo{.bitmapWidth      = glyph.width,
+                                   .bitmapHeight     = glyph.height,
+                                   .horizontalOffset = glyph.horizontalOffset,
+                                   .verticalOffset   = glyph.verticalOffset,
+                                   .packetLength     = uint16_t(packet.size()),
+                                   .advance          = glyph.advance,
+                                   .rleMetrics       = metrics,
+                                   .ligKernPgmIndex  = pgmIndexes[glyphCode],
+                                   .mainCode         = mainCode});
+    }
+    pixelsPool.insert(pixelsPool.end(), packet.begin(), packet.end());
+  }
+
+  // The glyphs info and pixels pool are padded to 32 bits
+  pixelsPool.resize(((glyphsInfo.size() + pixelsPool.size() + 3) & ~3) - glyphsInfo.size(), 0);
+
+  if (backup) {
+    for (auto &glyph : glyphs) {
+      for (auto &ligKern : glyph.ligKerns) {
+        if (!ligKern.isAKern) {
+          append(ligKernSteps, BackupGlyphLigStep{.nextCodePoint        = ligKern.nextCodePoint,
+                                                  .replacementCodePoint = char32_t(ligKern.value)});
+        }
+      }
+      for (auto &ligKern : glyph.ligKerns) {
+        if (ligKern.isAKern) {
+          append(ligKernSteps, BackupGlyphKernStep{.nextCodePoint = ligKern.nextCodePoint,
+                                                   .kern          = FIX16(ligKern.value)});
+        }
+      }
+    }
+  }
+
+  header.ligKernStepCount = backup ? 0 : ligKernSteps.size() / sizeof(LigKernStep);
+  header.pixelsPoolSize   = pixelsPool.size();
+
+  append(font, header);
+  for (auto index : poolIndexes) append(font, index);
+  font.insert(font.end(), glyphsInfo.begin(), glyphsInfo.end());
+  font.insert(font.end(), pixelsPool.begin(), pixelsPool.end());
+  font.insert(font.end(), ligKernSteps.begin(), ligKernSteps.end());
+  return true;
+}
+
+// The identical step sequences of the glyphs are written once. The first steps of the
+// table are the entries of the sequences: goTo steps to their first step.
+auto FontWriter::appendLigKernSteps(std::vector<uint8_t> &steps, const FontModel::Face &face,
+                                    const GlyphCodes          &glyphCodes,
+                                    std::vector<uint8_t> &pgmIndexes) const -> bool {
+  std::vector<std::vector<LigKernStep>> programs;
+  std::map<std::vector<uint32_t>, int>  programIndexes;
+  const char                           *error = nullptr;
+
+  for (auto &glyph : face.glyphs) {
+    if (glyph.ligKerns.empty()) {
+      pgmIndexes.push_back(255);
+      continue;
+    }
+
+    std::vector<LigKernStep> program;
+    std::vector<uint32_t>    key;
+    for (auto &ligKern : glyph.ligKerns) {
+      LigKernStep step{};
+      GlyphCode   next, replacement;
+
+      if (!findGlyphCode(glyphCodes, ligKern.nextCodePoint, next)) {
+        error = "lig/kern step with a next codePoint not in the face";
+        break;
+      }
+      step.a.data.nextGlyphCode = next;
+      if (ligKern.isAKern) {
+        if ((ligKern.value < -8192) || (ligKern.value > 8191)) {
+          error = "kerning value out of the FIX14 range";
+          break;
+        }
+        step.b.kern.kerningValue = ligKern.value;
+        step.b.kern.isAKern      = true;
+      } else {
+        if (!findGlyphCode(glyphCodes, ligKern.value, replacement)) {
+          error = "ligature with a replacement codePoint not in the face";
+          break;
+        }
+        step.b.repl.replGlyphCode = replacement;
+      }
+      program.push_back(step);
+      key.push_back((uint32_t(step.a.whole.val) << 16) | step.b.whole.val);
+    }
+    if (error != nullptr) break;
+
+    auto it = programIndexes.find(key);
+    if (it == programIndexes.end()) {
+      it = programIndexes.emplace(key, programs.size()).first;
+      programs.push_back(std::move(program));
+    }
+    pgmIndexes.push_back(it->second);
+  }
+
+  if ((error == nullptr) && (programs.size() > 254)) {
+    error = "more than 254 distinct lig/kern programs in a face";
+  }
+
+  // The last program needs no goTo step: it directly follows the others, at its index
+  int displacement = programs.empty() ? 0 : programs.size() - 1 + programs.back().size();
+  for (size_t idx = 0; (error == nullptr) && (idx + 1 < programs.size()); idx++) {
+    if (displacement > MAX_GOTO_DISPLACEMENT) {
+      error = "lig/kern table too large for the goTo steps";
+      break;
+    }
+    LigKernStep step{};
+    step.a.data.stop         = true;
+    step.b.goTo.displacement = displacement;
+    step.b.goTo.isAGoTo      = true;
+    step.b.goTo.isAKern      = true;
+    append(steps, step);
+    displacement += programs[idx].size();
+  }
+
+  if ((error == nullptr) && (displacement > 0xFFFF)) error = "too many lig/kern steps";
+
+  if (error != nullptr) {
+    std::cerr << "Unable to write the font: " << error << "." << std::endl;
+    return false;
+  }
+
+  if (!programs.empty()) std::rotate(programs.begin(), programs.end() - 1, programs.end());
+  for (auto &program : programs) {
+    program.back().a.data.stop = true;
+    for (auto &step : program) append(steps, step);
+  }
+  return true;
+}
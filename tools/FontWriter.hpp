@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cinttypes>
+#include <string>
+#include <vector>
+
+#include "FontModel.hpp"
+
+/**
+ * @brief Conversion of a font model to an IBMF v4 font.
+ *
+ * The glyph bitmaps are PK encoded, in the way RLEExtractor reads them, with the
+ * dynF of each glyph and repeat counts for the identical consecutive rows. The packets
+ * read from a font are kept as long as their glyph is unchanged. For the UTF32 and
+ * LATIN formats, identical ligature/kerning step sequences are shared by their glyphs,
+ * each sequence but the last one being reached through a goTo step located in the first
+ * 255 steps of the table.
+ *
+ */
+class FontWriter {
+public:
+  FontWriter(const FontModel &model) : model_(model) {}
+
+  // Returns false, with a message on std::cerr, if the model cannot be written in its
+  // format.
+  auto write(std::vector<uint8_t> &font) const -> bool;
+  auto save(const std::string &filename) const -> bool;
+
+  // Packs a bitmap with dynF 0 to 14, or with the dynF giving the smallest packet when
+  // dynF is -1. Returns the dynF in use.
+  static auto encodeBitmap(const FontModel::Glyph &glyph, int dynF, std::vector<uint8_t> &packet)
+      -> int;
+
+private:
+  const FontModel &model_;
+
+  // GlyphCode of each codePoint of a face, for the UTF32 and LATIN formats
+  typedef std::vector<std::pair<char32_t, GlyphCode>> GlyphCodes;
+
+  auto checkFaces() const -> bool;
+  auto appendPlanes(std::vector<uint8_t> &font) const -> void;
+  auto appendFace(std::vector<uint8_t> &font, const FontModel::Face &face) const -> bool;
+  auto appendLigKernSteps(std::vector<uint8_t> &steps, const FontModel::Face &face,
+                          const GlyphCodes &glyphCodes, std::vector<uint8_t> &pgmIndexes) const
+      -> bool;
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cinttypes>
+
+/**
+ * @brief Pseudo-random numbers of the font tools (SplitMix64).
+ *
+ * The sequence only depends on the seeds, such that the generated fonts and mutations
+ * are the same from one run to another, on every platform.
+ *
+ */
+class Random {
+public:
+  Random(uint64_t seed1, uint64_t seed2 = 0, uint64_t seed3 = 0)
+      : state_((seed1 * 0x9E3779B97F4A7C15ULL) ^ (seed2 * 0xC2B2AE3D27D4EB4FULL) ^
+               (seed3 * 0x165667B19E3779F9ULL)) {}
+
+  inline auto next() -> uint64_t {
+    uint64_t z = (state_ += 0x9E3779B97F4A7C15ULL);
+    z          = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z          = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+  }
+
+  // In [0, bound[
+  inline auto below(uint32_t bound) -> uint32_t { return next() % bound; }
+  // In [low, high]
+  inline auto range(int low, int high) -> int { return low + int(below(high - low + 1)); }
+  // True for about percentage percent of the calls
+  inline auto percent(int percentage) -> bool { return int(below(100)) < percentage; }
+
+private:
+  uint64_t state_;
+};
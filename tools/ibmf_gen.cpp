@@ -0,0 +1,174 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "FontGenerator.hpp"
+#include "FontMutator.hpp"
+#include "FontReader.hpp"
+#include "FontWriter.hpp"
+
+using namespace IBMFDefs;
+
+auto usage(char *name) -> void {
+  std::cout
+      << "Usage: " << name << " [options] <output-file>" << std::endl
+      << std::endl
+      << "Font options:" << std::endl
+      << "  --base <ibmf-file>            Start from an existing font" << std::endl
+      << "  --format utf32|latin|backup   Font format (default: utf32, or the base font one)"
+      << std::endl
+      << "  --faces <count>               Faces (default: 3)" << std::endl
+      << "  --glyphs <count>              Glyphs of each face (default: 1000)" << std::endl
+      << "  --bundle-size <count>         CodePoints of each bundle (default: 64)" << std::endl
+      << "  --lig-kern-density <percent>  Glyphs with lig/kern steps (default: 20)" << std::endl
+      << "  --lig-kern-steps <count>      Steps of each lig/kern program (default: 8)"
+      << std::endl
+      << "  --glyph-size <min>,<max>      Bitmap size range in pixels (default: 1,24)"
+      << std::endl
+      << "  --dyn-f <dynF>,...|best       RLE dynF distribution (default: best)" << std::endl
+      << "  --seed <number>               Generated content (default: 1)" << std::endl
+      << std::endl
+      << "Mutation options, as percentages of the glyphs:" << std::endl
+      << "  --mutate-seed <number>        Mutated glyphs and content (default: 1)" << std::endl
+      << "  --mutate-metrics <percent>    Advance and vertical offset changes" << std::endl
+      << "  --mutate-pixels <percent>     Bitmap changes" << std::endl
+      << "  --mutate-dyn-f <percent>      RLE dynF changes, with the same bitmaps" << std::endl
+      << "  --mutate-kerns <percent>      Kerning and ligature changes, of the steps" << std::endl
+      << "  --remove-glyphs <percent>     Glyphs removed" << std::endl
+      << "  --add-glyphs <percent>        Glyphs added after an existing one" << std::endl;
+  exit(1);
+}
+
+auto parseInt(const char *value, int &result) -> bool {
+  char *end;
+  long  number = strtol(value, &end, 10);
+  if ((*value == '\0') || (*end != '\0') || (number < INT32_MIN) || (number > INT32_MAX)) {
+    return false;
+  }
+  result = int(number);
+  return true;
+}
+
+auto parseFormat(const char *value, FontFormat &format) -> bool {
+  if (strcmp(value, "utf32") == 0) {
+    format = FontFormat::UTF32;
+  } else if (strcmp(value, "latin") == 0) {
+    format = FontFormat::LATIN;
+  } else if (strcmp(value, "backup") == 0) {
+    format = FontFormat::BACKUP;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+auto parseGlyphSize(const char *value, FontGeneratorOptions &options) -> bool {
+  const char *comma = strchr(value, ',');
+  if (comma == nullptr) return false;
+
+  std::string min(value, comma - value);
+  return parseInt(min.c_str(), options.minGlyphSize) &&
+         parseInt(comma + 1, options.maxGlyphSize);
+}
+
+auto parseDynFs(const char *value, std::vector<int> &dynFs) -> bool {
+  dynFs.clear();
+  if (strcmp(value, "best") == 0) return true;
+
+  std::string list(value);
+  size_t      start = 0;
+  while (start <= list.size()) {
+    size_t end = list.find(',', start);
+    if (end == std::string::npos) end = list.size();
+
+    int dynF;
+    if (!parseInt(list.substr(start, end - start).c_str(), dynF)) return false;
+    dynFs.push_back(dynF);
+    start = end + 1;
+  }
+  return true;
+}
+
+auto main(int argc, char **argv) -> int {
+
+  FontGeneratorOptions options;
+  MutationOptions      mutation;
+  const char          *base       = nullptr;
+  bool                 hasFormat  = false;
+  FontFormat           format     = FontFormat::UTF32;
+  int                  seed       = options.seed;
+  int                  mutateSeed = mutation.seed;
+  int                  argIdx     = 1;
+
+  for (; (argIdx < argc) && (strncmp(argv[argIdx], "--", 2) == 0); argIdx++) {
+    if (argIdx + 1 >= argc) usage(argv[0]);
+
+    const char *option = argv[argIdx];
+    const char *value  = argv[++argIdx];
+    bool        valid;
+
+    if (strcmp(option, "--base") == 0) {
+      base  = value;
+      valid = true;
+    } else if (strcmp(option, "--format") == 0) {
+      valid = hasFormat = parseFormat(value, format);
+    } else if (strcmp(option, "--faces") == 0) {
+      valid = parseInt(value, options.faceCount);
+    } else if (strcmp(option, "--glyphs") == 0) {
+      valid = parseInt(value, options.glyphCount);
+    } else if (strcmp(option, "--bundle-size") == 0) {
+      valid = parseInt(value, options.bundleSize);
+    } else if (strcmp(option, "--lig-kern-density") == 0) {
+      valid = parseInt(value, options.ligKernDensity);
+    } else if (strcmp(option, "--lig-kern-steps") == 0) {
+      valid = parseInt(value, options.ligKernSteps);
+    } else if (strcmp(option, "--glyph-size") == 0) {
+      valid = parseGlyphSize(value, options);
+    } else if (strcmp(option, "--dyn-f") == 0) {
+      valid = parseDynFs(value, options.dynFs);
+    } else if (strcmp(option, "--seed") == 0) {
+      valid = parseInt(value, seed);
+    } else if (strcmp(option, "--mutate-seed") == 0) {
+      valid = parseInt(value, mutateSeed);
+    } else if (strcmp(option, "--mutate-metrics") == 0) {
+      valid = parseInt(value, mutation.metrics);
+    } else if (strcmp(option, "--mutate-pixels") == 0) {
+      valid = parseInt(value, mutation.pixels);
+    } else if (strcmp(option, "--mutate-dyn-f") == 0) {
+      valid = parseInt(value, mutation.dynF);
+    } else if (strcmp(option, "--mutate-kerns") == 0) {
+      valid = parseInt(value, mutation.ligKerns);
+    } else if (strcmp(option, "--remove-glyphs") == 0) {
+      valid = parseInt(value, mutation.removedGlyphs);
+    } else if (strcmp(option, "--add-glyphs") == 0) {
+      valid = parseInt(value, mutation.addedGlyphs);
+    } else {
+      valid = false;
+    }
+
+    if (!valid) usage(argv[0]);
+  }
+
+  if (argc - argIdx != 1) {
+    usage(argv[0]);
+  }
+
+  options.seed  = seed;
+  mutation.seed = mutateSeed;
+  if (hasFormat) options.format = format;
+
+  FontModel model;
+
+  if (base != nullptr) {
+    if (!FontReader::read(base, model)) return 1;
+    if (hasFormat) model.format = format;
+  } else {
+    if (!FontGenerator(options).build(model)) return 1;
+  }
+
+  if (!FontMutator(mutation).mutate(model)) return 1;
+  if (!FontWriter(model).save(argv[argIdx])) return 1;
+
+  return 0;
+}